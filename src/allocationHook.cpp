@@ -0,0 +1,95 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+// Replacement of the global operator new / delete, counting net allocations for memoryUtils.
+// Only linked into the executable, ROOT and all tested libraries use it via symbol interposition.
+// Counting is off unless a test enables it, then it costs two relaxed atomic operations per call.
+
+#include "memoryUtils.h"
+
+#include <new>
+#include <stdlib.h>
+
+namespace {
+	struct hookRegistration {
+		hookRegistration() {
+			memoryUtils::markAllocationHookInstalled();
+		}
+	} gHookRegistration;
+
+	void* allocate(std::size_t aSize) {
+		if (aSize == 0) {
+			aSize = 1;
+		}
+		void* ptr = nullptr;
+		while ((ptr = malloc(aSize)) == nullptr) {
+			auto handler = std::get_new_handler();
+			if (handler == nullptr) {
+				throw std::bad_alloc();
+			}
+			handler();
+		}
+		memoryUtils::countAllocation(ptr);
+		return ptr;
+	}
+
+	void* allocateNoThrow(std::size_t aSize) noexcept {
+		try {
+			return allocate(aSize);
+		} catch (...) {
+			return nullptr;
+		}
+	}
+
+	void deallocate(void* aPtr) noexcept {
+		memoryUtils::countDeallocation(aPtr);
+		free(aPtr);
+	}
+}
+
+void* operator new(std::size_t aSize) {
+	return allocate(aSize);
+}
+
+void* operator new[](std::size_t aSize) {
+	return allocate(aSize);
+}
+
+void* operator new(std::size_t aSize, const std::nothrow_t&) noexcept {
+	return allocateNoThrow(aSize);
+}
+
+void* operator new[](std::size_t aSize, const std::nothrow_t&) noexcept {
+	return allocateNoThrow(aSize);
+}
+
+void operator delete(void* aPtr) noexcept {
+	deallocate(aPtr);
+}
+
+void operator delete[](void* aPtr) noexcept {
+	deallocate(aPtr);
+}
+
+void operator delete(void* aPtr, const std::nothrow_t&) noexcept {
+	deallocate(aPtr);
+}
+
+void operator delete[](void* aPtr, const std::nothrow_t&) noexcept {
+	deallocate(aPtr);
+}
@@ -0,0 +1,190 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "analyzerCore.h"
+
+#include <iostream>
+
+#include <TClass.h>
+
+#include "runHistory.h"
+#include "testInterface.h"
+#include "utilityFunctions.h"
+
+#include "testingInitHook.h"
+
+namespace {
+	analyzerCore* gInstance = nullptr;
+}
+
+analyzerCore::analyzerCore(bool aDebug) : lRunning{false}, lDebug{aDebug} {
+	if (gInstance != nullptr) {
+		std::cerr << "Only one analyzerCore may exist at a time, this one will not run any tests!" << std::endl;
+		return;
+	}
+	gInstance = this;
+	testingInitHook::initTests();
+	errorHandling::setDiagnosticListener([this](errorHandling::errorType aType, const char* aFile, Int_t aLine, const char* aMessage,
+	                                            const std::string* aTestName, const std::string* aClassName) {
+		if (aTestName == nullptr || aClassName == nullptr) {
+			// Not issued for a test on a class, there is no result to attach it to.
+			return;
+		}
+		fOnDiagnostic(diagnostic{aType, aFile, aLine, aMessage}, *aTestName, *aClassName);
+	});
+	testInterface::fGetResultListener() = [this](const testInterface& aTest, classObject& aClass, classObject::testStatus aStatus, Double_t aNs) {
+		fOnResult(aTest.fGetTestName(), aClass.fGetClassName(), aStatus, aNs);
+	};
+}
+
+analyzerCore::~analyzerCore() {
+	fWait();
+	if (gInstance == this) {
+		errorHandling::setDiagnosticListener(errorHandling::diagnosticListener());
+		testInterface::fGetResultListener() = testInterface::resultListener();
+		gInstance = nullptr;
+	}
+}
+
+void analyzerCore::fOnDiagnostic(const diagnostic& aDiagnostic, const std::string& aTestName, const std::string& aClassName) {
+	// Called with the diagnostics lock held, so nothing here may issue diagnostics or wait for lResultMutex.
+	std::lock_guard<std::mutex> lock(lPendingMutex);
+	lPendingDiagnostics[testAndClass(aTestName, aClassName)].push_back(aDiagnostic);
+}
+
+void analyzerCore::fOnResult(const std::string& aTestName, const std::string& aClassName, classObject::testStatus aStatus, Double_t aNs) {
+	testResult result{aTestName, aClassName, aStatus, aNs, std::vector<diagnostic>(), false};
+	testAndClass key(aTestName, aClassName);
+	{
+		std::lock_guard<std::mutex> lock(lPendingMutex);
+		auto pending = lPendingDiagnostics.find(key);
+		if (pending != lPendingDiagnostics.end()) {
+			result.lDiagnostics.swap(pending->second);
+			lPendingDiagnostics.erase(pending);
+		}
+	}
+	std::lock_guard<std::mutex> lock(lResultMutex);
+	if (lCallback) {
+		lCallback(result);
+	}
+	lResultIndex[key] = lResults.size();
+	lResults.push_back(std::move(result));
+}
+
+void analyzerCore::fDeliverSupplements() {
+	std::map<testAndClass, std::vector<diagnostic>> late;
+	{
+		std::lock_guard<std::mutex> lock(lPendingMutex);
+		late.swap(lPendingDiagnostics);
+	}
+	std::lock_guard<std::mutex> lock(lResultMutex);
+	for (auto& entry : late) {
+		auto index = lResultIndex.find(entry.first);
+		if (index == lResultIndex.end()) {
+			// Belongs to no result of this run (e.g. a test reporting from fFinalize() with a context set).
+			continue;
+		}
+		auto& result = lResults[index->second];
+		testResult supplement{result.lTestName, result.lClassName, result.lStatus, result.lNs, entry.second, true};
+		result.lDiagnostics.insert(result.lDiagnostics.end(), entry.second.begin(), entry.second.end());
+		if (lCallback) {
+			lCallback(supplement);
+		}
+	}
+}
+
+bool analyzerCore::fRegisterClass(TClass* aClass) {
+	if (aClass == nullptr || lRunning) {
+		return false;
+	}
+	for (auto cls : lClasses) {
+		if (cls == aClass) {
+			return false;
+		}
+	}
+	lClasses.push_back(aClass);
+	return true;
+}
+
+void analyzerCore::fSelectTests(const std::vector<std::string>& aTestNamePatterns, const std::vector<std::string>& aTestNameAntiPatterns) {
+	lTestNamePatterns = aTestNamePatterns;
+	lTestNameAntiPatterns = aTestNameAntiPatterns;
+}
+
+void analyzerCore::fSetResultCallback(resultCallback aCallback) {
+	std::lock_guard<std::mutex> lock(lResultMutex);
+	lCallback = aCallback;
+}
+
+std::size_t analyzerCore::fRun() {
+	if (gInstance != this) {
+		return 0;
+	}
+	bool expected = false;
+	if (!lRunning.compare_exchange_strong(expected, true)) {
+		return 0;
+	}
+	return fExecute();
+}
+
+std::size_t analyzerCore::fExecute() {
+	lResults.clear();
+	lResultIndex.clear();
+	{
+		std::lock_guard<std::mutex> lock(lPendingMutex);
+		lPendingDiagnostics.clear();
+	}
+
+	// Fresh table each run, so all tests run again. Inheritance queries fall back to TClass without a hierarchy index.
+	classTable allClassObjects(testInterface::fGetTestIdCount());
+	for (auto cls : lClasses) {
+		allClassObjects.fAddClass(cls);
+	}
+	auto selectedTests = utilityFunctions::selectTestsByPatterns(lTestNamePatterns, lTestNameAntiPatterns, lDebug);
+	auto orderedRows = runHistory::fOrderRows(allClassObjects);
+	auto testsRun = testInterface::fRunTests(allClassObjects, selectedTests, &orderedRows, lDebug);
+	for (auto test : selectedTests) {
+		test->fFinalize();
+	}
+	fDeliverSupplements();
+
+	lRunning = false;
+	return testsRun;
+}
+
+bool analyzerCore::fRunInBackground() {
+	if (gInstance != this) {
+		return false;
+	}
+	bool expected = false;
+	if (!lRunning.compare_exchange_strong(expected, true)) {
+		return false;
+	}
+	// An earlier background run has finished, but its thread still needs to be joined.
+	fWait();
+	lWorker = std::thread([this]() {
+		fExecute();
+	});
+	return true;
+}
+
+void analyzerCore::fWait() {
+	if (lWorker.joinable()) {
+		lWorker.join();
+	}
+}
@@ -0,0 +1,418 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "analyzerDaemon.h"
+
+#include "testInterface.h"
+#include "utilityFunctions.h"
+
+#include <TClass.h>
+#include <TSystem.h>
+#include <TString.h>
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <map>
+#include <set>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// Set by a daemon for the process it re-executes into, to the state file handed over.
+static const char* const kHandoverVariable = "ROOTSTATICANALYZER_DAEMON_HANDOVER";
+
+static bool readLine(int aFd, std::string& aBuffer, std::string& aLine) {
+	while (true) {
+		auto newline = aBuffer.find('\n');
+		if (newline != std::string::npos) {
+			aLine = aBuffer.substr(0, newline);
+			aBuffer.erase(0, newline + 1);
+			if (!aLine.empty() && aLine.back() == '\r') {
+				aLine.pop_back();
+			}
+			return true;
+		}
+		char chunk[4096];
+		auto bytesRead = read(aFd, chunk, sizeof(chunk));
+		if (bytesRead < 0 && errno == EINTR) {
+			continue;
+		}
+		if (bytesRead <= 0) {
+			return false;
+		}
+		aBuffer.append(chunk, bytesRead);
+	}
+}
+
+static bool isStreamSocket(int aFd) {
+	struct stat fdStat;
+	if (fstat(aFd, &fdStat) != 0 || !S_ISSOCK(fdStat.st_mode)) {
+		return false;
+	}
+	int type = 0;
+	socklen_t typeLength = sizeof(type);
+	return getsockopt(aFd, SOL_SOCKET, SO_TYPE, &type, &typeLength) == 0 && type == SOCK_STREAM;
+}
+
+static void sendLine(int aFd, const std::string& aLine) {
+	std::string data = aLine + "\n";
+	std::size_t sent = 0;
+	while (sent < data.size()) {
+		auto bytesSent = send(aFd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+		if (bytesSent < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			// Client went away, nothing we can do about it.
+			return;
+		}
+		sent += bytesSent;
+	}
+}
+
+analyzerDaemon::analyzerDaemon(classTable& aClasses, const std::string& aSocketPath, bool aDebug) :
+	lClasses(aClasses),
+	lSocketPath{aSocketPath},
+	lDebug{aDebug} {
+	fCollectLibraries();
+}
+
+void analyzerDaemon::fCollectLibraries() {
+	std::map<std::string, UInt_t> libraryIds;
+	for (auto cls : lClasses) {
+		UInt_t libraryId = kNoLibrary;
+		auto libraryPath = utilityFunctions::getProvidingLibraryPath(cls.fGetTClass());
+		if (!libraryPath.empty()) {
+			auto known = libraryIds.find(libraryPath);
+			if (known == libraryIds.end()) {
+				FileStat_t stat;
+				Long_t mtime = 0;
+				if (gSystem->GetPathInfo(libraryPath.c_str(), stat) == 0) {
+					mtime = stat.fMtime;
+				}
+				known = libraryIds.emplace(libraryPath, lLibraries.size()).first;
+				lLibraries.push_back(libraryPath);
+				lLibraryMTimes.push_back(mtime);
+			}
+			libraryId = known->second;
+		}
+		lClassLibraries.push_back(libraryId);
+	}
+	if (lDebug) {
+		std::cout << "Daemon watches " << lLibraries.size() << " libraries for changes." << std::endl;
+	}
+}
+
+bool analyzerDaemon::fLibraryChanged(UInt_t aLibrary) const {
+	FileStat_t stat;
+	if (gSystem->GetPathInfo(lLibraries[aLibrary].c_str(), stat) != 0) {
+		// Gone, e.g. in the middle of a rebuild.
+		return true;
+	}
+	return stat.fMtime != lLibraryMTimes[aLibrary];
+}
+
+analyzerDaemon::connectionAction analyzerDaemon::fHandleConnection(int aFd, request& aRequest) {
+	std::string buffer;
+	std::string line;
+	bool run = false;
+	while (readLine(aFd, buffer, line)) {
+		if (line.empty()) {
+			continue;
+		}
+		auto space = line.find(' ');
+		std::string keyword = line.substr(0, space);
+		std::string argument = (space != std::string::npos) ? line.substr(space + 1) : "";
+		if (keyword == "class") {
+			aRequest.lClassPatterns.push_back(argument);
+		} else if (keyword == "anticlass") {
+			aRequest.lClassAntiPatterns.push_back(argument);
+		} else if (keyword == "test") {
+			aRequest.lTestPatterns.push_back(argument);
+		} else if (keyword == "antitest") {
+			aRequest.lTestAntiPatterns.push_back(argument);
+		} else if (keyword == "run") {
+			run = true;
+			break;
+		} else if (keyword == "quit") {
+			sendLine(aFd, "done\t0\t0");
+			return kQuit;
+		} else {
+			sendLine(aFd, "error\tunknown command '" + keyword + "'");
+		}
+	}
+	if (!run) {
+		return kContinue;
+	}
+	return fAnswerRequest(aFd, aRequest);
+}
+
+analyzerDaemon::connectionAction analyzerDaemon::fAnswerRequest(int aFd, const request& aRequest) {
+	std::set<std::string> classNames;
+	for (auto cls : lClasses) {
+		classNames.insert(cls.fGetClassName());
+	}
+	utilityFunctions::filterSetByPatterns(classNames, aRequest.lClassPatterns, aRequest.lClassAntiPatterns, lDebug);
+	std::vector<std::size_t> rows;
+	for (auto& className : classNames) {
+		rows.push_back(lClasses.fFindClass(className));
+	}
+
+	// Changed code can not be reloaded into a running process, so we need a fresh start for that.
+	std::set<UInt_t> staleLibraries;
+	for (auto row : rows) {
+		auto library = lClassLibraries[row];
+		if (library != kNoLibrary && fLibraryChanged(library)) {
+			staleLibraries.insert(library);
+		}
+	}
+	if (!staleLibraries.empty()) {
+		for (auto library : staleLibraries) {
+			sendLine(aFd, "stale\t" + lLibraries[library]);
+		}
+		sendLine(aFd, "restart");
+		return kRestart;
+	}
+
+	auto tests = utilityFunctions::selectTestsByPatterns(aRequest.lTestPatterns, aRequest.lTestAntiPatterns, lDebug);
+
+	// Diagnostics go to std::cerr, catch them to hand them to the client.
+	std::ostringstream diagnostics;
+	auto oldCerrBuffer = std::cerr.rdbuf(diagnostics.rdbuf());
+	testInterface::fRunTests(lClasses, tests, &rows, lDebug);
+	std::cerr.rdbuf(oldCerrBuffer);
+
+	std::istringstream diagnosticLines(diagnostics.str());
+	std::string line;
+	while (std::getline(diagnosticLines, line)) {
+		sendLine(aFd, "diagnostic\t" + line);
+	}
+	for (auto row : rows) {
+		auto cls = lClasses[row];
+		for (auto test : tests) {
+			sendLine(aFd, "result\t" + cls.fGetClassName() + "\t" + test->fGetTestName() + "\t"
+			         + classObject::fGetStatusName(cls.fGetTestStatus(test->fGetId())));
+		}
+	}
+	sendLine(aFd, TString::Format("done\t%zu\t%zu", rows.size(), tests.size()).Data());
+	return kContinue;
+}
+
+bool analyzerDaemon::fWriteState(int aFd, const request& aRequest) {
+	// The connection survives execv() unless it is close-on-exec.
+	auto fdFlags = fcntl(aFd, F_GETFD);
+	if (fdFlags < 0 || fcntl(aFd, F_SETFD, fdFlags & ~FD_CLOEXEC) != 0) {
+		return false;
+	}
+	// Write to a temporary file first, the new process must not pick up a partial state.
+	std::string temporaryPath = fGetStatePath() + ".tmp";
+	std::ofstream output(temporaryPath, std::ios::trunc);
+	output << "connection\t" << aFd << std::endl;
+	for (auto& pattern : aRequest.lClassPatterns) {
+		output << "class\t" << pattern << std::endl;
+	}
+	for (auto& pattern : aRequest.lClassAntiPatterns) {
+		output << "anticlass\t" << pattern << std::endl;
+	}
+	for (auto& pattern : aRequest.lTestPatterns) {
+		output << "test\t" << pattern << std::endl;
+	}
+	for (auto& pattern : aRequest.lTestAntiPatterns) {
+		output << "antitest\t" << pattern << std::endl;
+	}
+	// Results of classes from changed libraries are dropped, they are tested again by the new process.
+	std::vector<bool> changedLibraries(lLibraries.size());
+	for (UInt_t library = 0; library < lLibraries.size(); ++library) {
+		changedLibraries[library] = fLibraryChanged(library);
+	}
+	auto& allTests = testInterface::fGetAllTests();
+	for (std::size_t row = 0; row < lClasses.size(); ++row) {
+		auto library = lClassLibraries[row];
+		if (library != kNoLibrary && changedLibraries[library]) {
+			continue;
+		}
+		auto cls = lClasses[row];
+		for (auto& test : allTests) {
+			auto status = cls.fGetTestStatus(test.second->fGetId());
+			if (status != classObject::kNotRun) {
+				// status <tab> test <tab> class, the class name goes last as it may contain anything but tabs.
+				output << "result\t" << static_cast<unsigned int>(status) << "\t" << test.first << "\t" << cls.fGetClassName() << std::endl;
+			}
+		}
+	}
+	output.close();
+	if (!output) {
+		return false;
+	}
+	return rename(temporaryPath.c_str(), fGetStatePath().c_str()) == 0;
+}
+
+int analyzerDaemon::fReadState(request& aRequest) {
+	auto statePath = fGetStatePath();
+	// Only a process started by our own restart takes over, anything else is left over by a killed daemon.
+	auto handover = getenv(kHandoverVariable);
+	bool handedOver = (handover != nullptr && statePath == handover);
+	unsetenv(kHandoverVariable);
+	if (!handedOver) {
+		unlink(statePath.c_str());
+		return -1;
+	}
+	std::ifstream input(statePath);
+	if (!input) {
+		return -1;
+	}
+	int fd = -1;
+	std::size_t restoredResults = 0;
+	auto& allTests = testInterface::fGetAllTests();
+	std::string line;
+	while (std::getline(input, line)) {
+		auto tab = line.find('\t');
+		if (tab == std::string::npos) {
+			continue;
+		}
+		std::string keyword = line.substr(0, tab);
+		std::string argument = line.substr(tab + 1);
+		if (keyword == "connection") {
+			fd = atoi(argument.c_str());
+		} else if (keyword == "class") {
+			aRequest.lClassPatterns.push_back(argument);
+		} else if (keyword == "anticlass") {
+			aRequest.lClassAntiPatterns.push_back(argument);
+		} else if (keyword == "test") {
+			aRequest.lTestPatterns.push_back(argument);
+		} else if (keyword == "antitest") {
+			aRequest.lTestAntiPatterns.push_back(argument);
+		} else if (keyword == "result") {
+			char* end = nullptr;
+			auto status = strtoul(argument.c_str(), &end, 10);
+			if (end == argument.c_str() || *end != '\t' || status > classObject::kTimeout) {
+				continue;
+			}
+			auto testStart = end + 1 - argument.c_str();
+			auto testEnd = argument.find('\t', testStart);
+			if (testEnd == std::string::npos) {
+				continue;
+			}
+			auto test = allTests.find(argument.substr(testStart, testEnd - testStart));
+			auto row = lClasses.fFindClass(argument.substr(testEnd + 1));
+			if (test == allTests.end() || row == classTable::kNotFound) {
+				continue;
+			}
+			lClasses[row].fMarkTested(test->second->fGetId(), static_cast<classObject::testStatus>(status));
+			restoredResults++;
+		}
+	}
+	input.close();
+	unlink(statePath.c_str());
+	if (lDebug) {
+		std::cout << "Daemon restored " << restoredResults << " results from before the restart." << std::endl;
+	}
+	if (fd >= 0 && !isStreamSocket(fd)) {
+		std::cerr << "Connection " << fd << " handed over by the restart is no socket, the pending request is dropped." << std::endl;
+		return -1;
+	}
+	if (fd >= 0) {
+		// Our own connections are close-on-exec again.
+		fcntl(fd, F_SETFD, fcntl(fd, F_GETFD) | FD_CLOEXEC);
+	}
+	return fd;
+}
+
+int analyzerDaemon::fServe(char** aArgv) {
+	sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (lSocketPath.size() >= sizeof(address.sun_path)) {
+		std::cerr << "Socket path '" << lSocketPath << "' is too long!" << std::endl;
+		return 1;
+	}
+	strncpy(address.sun_path, lSocketPath.c_str(), sizeof(address.sun_path) - 1);
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd < 0) {
+		perror("socket");
+		return 1;
+	}
+	unlink(lSocketPath.c_str());
+	if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+	    || listen(listenFd, 8) != 0) {
+		perror("bind / listen");
+		close(listenFd);
+		return 1;
+	}
+	std::cout << "Daemon serving " << lClasses.size() << " classes on '" << lSocketPath << "'." << std::endl;
+
+	// After a restart, the request which triggered it is answered first.
+	request pendingRequest;
+	int pendingFd = fReadState(pendingRequest);
+
+	while (true) {
+		request currentRequest;
+		connectionAction action;
+		int connectionFd = -1;
+		if (pendingFd >= 0) {
+			connectionFd = pendingFd;
+			pendingFd = -1;
+			currentRequest = pendingRequest;
+			action = fAnswerRequest(connectionFd, currentRequest);
+		} else {
+			connectionFd = accept(listenFd, nullptr, nullptr);
+			if (connectionFd < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				perror("accept");
+				break;
+			}
+			action = fHandleConnection(connectionFd, currentRequest);
+		}
+		if (action == kRestart) {
+			if (fWriteState(connectionFd, currentRequest)) {
+				setenv(kHandoverVariable, fGetStatePath().c_str(), 1);
+			} else {
+				sendLine(connectionFd, "error\tstate file '" + fGetStatePath() + "' could not be written, resend the request");
+				close(connectionFd);
+			}
+		} else {
+			close(connectionFd);
+		}
+		if (action == kQuit) {
+			break;
+		}
+		if (action == kRestart) {
+			// The connection stays open, the new process answers on it.
+			std::cout << "Libraries changed, restarting daemon." << std::endl;
+			close(listenFd);
+			unlink(lSocketPath.c_str());
+			execv("/proc/self/exe", aArgv);
+			perror("execv");
+			return 1;
+		}
+	}
+	close(listenFd);
+	unlink(lSocketPath.c_str());
+	return 0;
+}
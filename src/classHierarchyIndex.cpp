@@ -0,0 +1,144 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "classHierarchyIndex.h"
+
+#include <TClass.h>
+#include <TList.h>
+#include <TBaseClass.h>
+
+UInt_t classHierarchyIndex::fAssignIds(TClass* aClass) {
+	auto known = lIdsByClass.find(aClass);
+	if (known != lIdsByClass.end()) {
+		return known->second;
+	}
+	UInt_t id = lClasses.size();
+	lClasses.push_back(aClass);
+	lDirectBases.emplace_back();
+	lBaseColumns.push_back(kInvalidId);
+	lIdsByClass[aClass] = id;
+	lIdsByName[aClass->GetName()] = id;
+
+	std::vector<UInt_t> directBases;
+	auto bases = aClass->GetListOfBases();
+	if (bases != nullptr) {
+		TIter nextBase(bases);
+		TBaseClass* base = nullptr;
+		while ((base = dynamic_cast<TBaseClass*>(nextBase())) != nullptr) {
+			auto baseClass = base->GetClassPointer();
+			if (baseClass == nullptr) {
+				// No dictionary for the base, nothing we could query by TClass anyways.
+				continue;
+			}
+			directBases.push_back(fAssignIds(baseClass));
+		}
+	}
+	// lDirectBases may have been reallocated by the recursion, only index it now.
+	lDirectBases[id] = directBases;
+	return id;
+}
+
+void classHierarchyIndex::fFillRow(UInt_t aId, std::vector<bool>& aDone) {
+	if (aDone[aId]) {
+		return;
+	}
+	aDone[aId] = true;
+	auto row = &lBaseBits[aId * lWordsPerRow];
+	for (auto baseId : lDirectBases[aId]) {
+		fFillRow(baseId, aDone);
+		auto column = lBaseColumns[baseId];
+		row[column / 64] |= (1ULL << (column % 64));
+		auto baseRow = &lBaseBits[baseId * lWordsPerRow];
+		for (std::size_t word = 0; word < lWordsPerRow; ++word) {
+			row[word] |= baseRow[word];
+		}
+	}
+}
+
+void classHierarchyIndex::fBuild(const std::vector<TClass*>& aClasses) {
+	lClasses.clear();
+	lDirectBases.clear();
+	lBaseColumns.clear();
+	lBaseBits.clear();
+	lIdsByClass.clear();
+	lIdsByName.clear();
+
+	for (auto cls : aClasses) {
+		fAssignIds(cls);
+	}
+
+	// Only classes which are a base of anything need a column, that keeps the matrix small.
+	UInt_t columns = 0;
+	for (auto& bases : lDirectBases) {
+		for (auto baseId : bases) {
+			if (lBaseColumns[baseId] == kInvalidId) {
+				lBaseColumns[baseId] = columns++;
+			}
+		}
+	}
+	lWordsPerRow = (columns + 63) / 64;
+	lBaseBits.assign(lClasses.size() * lWordsPerRow, 0);
+
+	std::vector<bool> done(lClasses.size(), false);
+	for (UInt_t id = 0; id < lClasses.size(); ++id) {
+		fFillRow(id, done);
+	}
+}
+
+UInt_t classHierarchyIndex::fGetId(const TClass* aClass) const {
+	auto known = lIdsByClass.find(aClass);
+	return (known != lIdsByClass.end()) ? known->second : kInvalidId;
+}
+
+UInt_t classHierarchyIndex::fGetId(const std::string& aClassName) const {
+	auto known = lIdsByName.find(aClassName);
+	return (known != lIdsByName.end()) ? known->second : kInvalidId;
+}
+
+bool classHierarchyIndex::fInheritsFrom(const TClass* aClass, const TClass* aBase) const {
+	auto id = fGetId(aClass);
+	auto baseId = fGetId(aBase);
+	if (id == kInvalidId || baseId == kInvalidId) {
+		return aClass->InheritsFrom(aBase);
+	}
+	return fInheritsFrom(id, baseId);
+}
+
+bool classHierarchyIndex::fInheritsFrom(const TClass* aClass, const char* aBaseName) const {
+	auto id = fGetId(aClass);
+	auto baseId = fGetId(aBaseName);
+	if (id == kInvalidId) {
+		return aClass->InheritsFrom(aBaseName);
+	}
+	// An unknown base can not be a base of any indexed class, all bases are indexed.
+	return fInheritsFrom(id, baseId);
+}
+
+std::vector<TClass*> classHierarchyIndex::fGetSubclasses(const TClass* aBase) const {
+	std::vector<TClass*> subclasses;
+	auto baseId = fGetId(aBase);
+	if (baseId == kInvalidId) {
+		return subclasses;
+	}
+	for (UInt_t id = 0; id < lClasses.size(); ++id) {
+		if (fInheritsFrom(id, baseId)) {
+			subclasses.push_back(lClasses[id]);
+		}
+	}
+	return subclasses;
+}
@@ -17,21 +17,88 @@
 */
 
 #include "classObject.h"
+#include "classHierarchyIndex.h"
 
 #include <TObject.h>
 #include <TClass.h>
 #include <TInterpreter.h>
 
-classObject::classObject(TClass* aClass) :
-	lClass{aClass},
-	lClassName{aClass->GetName()},
-	lInheritsTObject{lClass->InheritsFrom(TObject::Class())},
-	lIsDataObject{lInheritsTObject && !(lClass->GetClassVersion() <= 0)},
-	lHasNew{lClass->GetNew() != nullptr},
-	lHasDelete{lClass->GetDestructor() != nullptr} {
-		if (aClass->GetClassInfo() != nullptr) {
-			lHasDefaultConstructor = gInterpreter->ClassInfo_HasDefaultConstructor(aClass->GetClassInfo());
-		} else {
-			lHasDefaultConstructor = lHasNew;
+#include <algorithm>
+
+void classTable::fAddName(const std::string& aClassName, std::size_t aIndex) {
+	auto name = lNameLookup.find(aClassName);
+	if (name == lNameLookup.end()) {
+		name = lNameLookup.emplace(aClassName, lNames.size()).first;
+		lNames.push_back(aClassName);
+		lRowsByNameId.push_back(aIndex);
+	}
+	lNameIds.push_back(name->second);
+}
+
+std::size_t classTable::fAddClass(TClass* aClass) {
+	std::size_t index = lClasses.size();
+	lClasses.push_back(aClass);
+	fAddName(aClass->GetName(), index);
+
+	UChar_t flags = 0;
+	bool inheritsTObject = classHierarchyIndex::fGetIndex().fInheritsFrom(aClass, TObject::Class());
+	bool hasNew = (aClass->GetNew() != nullptr);
+	bool hasDefaultConstructor = hasNew;
+	if (aClass->GetClassInfo() != nullptr) {
+		hasDefaultConstructor = gInterpreter->ClassInfo_HasDefaultConstructor(aClass->GetClassInfo());
+	}
+	if (inheritsTObject) {
+		flags |= kInheritsTObject;
+		if (!(aClass->GetClassVersion() <= 0)) {
+			flags |= kIsDataObject;
 		}
-	};
+	}
+	if (hasNew) {
+		flags |= kHasNew;
+	}
+	if (aClass->GetDestructor() != nullptr) {
+		flags |= kHasDelete;
+	}
+	if (hasDefaultConstructor) {
+		flags |= kHasDefaultConstructor;
+	}
+	lFlags.push_back(flags);
+
+	lTestStatus.resize(lTestStatus.size() + lTestColumns, classObject::kNotRun);
+	lSnapshots.emplace_back(nullptr);
+	return index;
+}
+
+std::size_t classTable::fAddSnapshot(std::unique_ptr<const reflectionSnapshot> aSnapshot, UChar_t aFlags) {
+	std::size_t index = lClasses.size();
+	lClasses.push_back(nullptr);
+	fAddName(aSnapshot->fGetClassName(), index);
+	lFlags.push_back(aFlags | kFromSnapshotFile);
+	lTestStatus.resize(lTestStatus.size() + lTestColumns, classObject::kNotRun);
+	lSnapshots.emplace_back(std::move(aSnapshot));
+	return index;
+}
+
+const reflectionSnapshot& classTable::fBuildSnapshot(std::size_t aIndex) {
+	lSnapshots[aIndex].reset(new reflectionSnapshot(lClasses[aIndex]));
+	return *lSnapshots[aIndex];
+}
+
+std::size_t classTable::fFindClass(const std::string& aClassName) const {
+	auto name = lNameLookup.find(aClassName);
+	if (name == lNameLookup.end()) {
+		return kNotFound;
+	}
+	return lRowsByNameId[name->second];
+}
+
+void classTable::fResizeTestColumns(std::size_t aTestColumns) {
+	// Rare: only needed if a test-ID appears which was not known when the table was created.
+	std::vector<UChar_t> newTestStatus(lClasses.size() * aTestColumns, classObject::kNotRun);
+	for (std::size_t index = 0; index < lClasses.size(); ++index) {
+		auto oldRow = lTestStatus.begin() + index * lTestColumns;
+		std::copy(oldRow, oldRow + lTestColumns, newTestStatus.begin() + index * aTestColumns);
+	}
+	lTestStatus.swap(newTestStatus);
+	lTestColumns = aTestColumns;
+}
@@ -0,0 +1,220 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "crashHandling.h"
+
+#include "errorHandling.h"
+
+#include <TEnv.h>
+#include <TString.h>
+
+#include <map>
+#include <vector>
+
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <elf.h>
+#include <execinfo.h>
+#include <link.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+	const int kMaxFrames = 64;
+	const int kHandledSignals[] = { SIGSEGV, SIGBUS, SIGILL, SIGFPE };
+
+	// Written from the signal handler only.
+	void* gCapturedFrames[kMaxFrames];
+	volatile sig_atomic_t gCapturedFrameCount = 0;
+	volatile sig_atomic_t gCapturedSignal = 0;
+
+	struct sigaction gPreviousActions[NSIG];
+
+	struct crashRecord {
+		std::string lTestName;
+		std::string lClassName;
+		std::string lDeclFileName;
+		int lSignal;
+		std::vector<void*> lFrames;
+	};
+	std::vector<crashRecord> gPendingCrashes;
+
+	// Address => "function at file:line (module)", shared across all crashes.
+	std::map<void*, std::string> gSymbolCache;
+
+	void crashSignalHandler(int aSignal, siginfo_t* aInfo, void* aContext) {
+		// backtrace() was called once at installation, so libgcc is loaded and this does not allocate.
+		gCapturedFrameCount = backtrace(gCapturedFrames, kMaxFrames);
+		gCapturedSignal = aSignal;
+
+		// Hand over to ROOT which turns the signal into a longjmp to the enclosing TRY.
+		auto& previous = gPreviousActions[aSignal];
+		if (previous.sa_flags & SA_SIGINFO) {
+			previous.sa_sigaction(aSignal, aInfo, aContext);
+		} else if (previous.sa_handler != SIG_DFL && previous.sa_handler != SIG_IGN) {
+			previous.sa_handler(aSignal);
+		} else {
+			signal(aSignal, SIG_DFL);
+			raise(aSignal);
+		}
+	}
+
+	std::string demangle(const char* aSymbol) {
+		if (aSymbol == nullptr) {
+			return "??";
+		}
+		int status = 0;
+		char* demangled = abi::__cxa_demangle(aSymbol, nullptr, nullptr, &status);
+		if (status != 0 || demangled == nullptr) {
+			return aSymbol;
+		}
+		std::string result(demangled);
+		free(demangled);
+		return result;
+	}
+
+	// Resolve all given addresses, one addr2line-call per module.
+	void symbolize(const std::vector<void*>& aAddresses) {
+		struct lookup {
+			void* lAddress;
+			uintptr_t lModuleAddress;
+			std::string lFallback;
+		};
+		std::map<std::string, std::vector<lookup>> lookupsByModule;
+		for (auto address : aAddresses) {
+			Dl_info info;
+			if (dladdr(address, &info) == 0 || info.dli_fname == nullptr) {
+				gSymbolCache[address] = "??";
+				continue;
+			}
+			// Return addresses point behind the call, look up the call itself.
+			auto pc = reinterpret_cast<uintptr_t>(address) - 1;
+			auto base = reinterpret_cast<uintptr_t>(info.dli_fbase);
+			// Position-dependent executables are looked up by absolute address, everything else relative to its base.
+			auto header = reinterpret_cast<const ElfW(Ehdr)*>(info.dli_fbase);
+			auto moduleAddress = (header->e_type == ET_EXEC) ? pc : pc - base;
+			lookup entry{address, moduleAddress,
+			             demangle(info.dli_sname) + " (" + info.dli_fname + ")"};
+			lookupsByModule[info.dli_fname].push_back(entry);
+		}
+		for (auto& module : lookupsByModule) {
+			TString command = TString::Format("addr2line -C -f -e '%s'", module.first.c_str());
+			for (auto& entry : module.second) {
+				command += TString::Format(" 0x%lx", static_cast<unsigned long>(entry.lModuleAddress));
+			}
+			command += " 2>/dev/null";
+			FILE* pipe = popen(command.Data(), "r");
+			for (auto& entry : module.second) {
+				char function[4096];
+				char location[4096];
+				bool resolved = (pipe != nullptr)
+				                && fgets(function, sizeof(function), pipe) != nullptr
+				                && fgets(location, sizeof(location), pipe) != nullptr;
+				if (resolved) {
+					function[strcspn(function, "\n")] = '\0';
+					location[strcspn(location, "\n")] = '\0';
+				}
+				if (!resolved || strncmp(location, "??", 2) == 0) {
+					gSymbolCache[entry.lAddress] = entry.lFallback;
+				} else {
+					gSymbolCache[entry.lAddress] = std::string(function) + " at " + location + " (" + module.first + ")";
+				}
+			}
+			if (pipe != nullptr) {
+				pclose(pipe);
+			}
+		}
+	}
+}
+
+void crashHandling::fInstall() {
+	// ROOT's own stacktrace starts gdb, which takes seconds per crash.
+	gEnv->SetValue("Root.Stacktrace", 0);
+
+	// Warm up, the first call may load libgcc and allocate - not allowed later in the handler.
+	void* warmupFrames[2];
+	backtrace(warmupFrames, 2);
+
+	for (auto sig : kHandledSignals) {
+		struct sigaction action;
+		memset(&action, 0, sizeof(action));
+		action.sa_sigaction = crashSignalHandler;
+		sigemptyset(&action.sa_mask);
+		action.sa_flags = SA_SIGINFO;
+		sigaction(sig, &action, &gPreviousActions[sig]);
+	}
+}
+
+void crashHandling::fArm() {
+	gCapturedFrameCount = 0;
+	gCapturedSignal = 0;
+}
+
+bool crashHandling::fCrashCaptured() {
+	return gCapturedFrameCount > 0;
+}
+
+void crashHandling::fCollectCrash(const std::string& aTestName, const std::string& aClassName, const char* aDeclFileName) {
+	crashRecord record;
+	record.lTestName = aTestName;
+	record.lClassName = aClassName;
+	record.lDeclFileName = (aDeclFileName != nullptr) ? aDeclFileName : "";
+	record.lSignal = gCapturedSignal;
+	// Skip our handler itself.
+	for (int frame = 1; frame < gCapturedFrameCount; ++frame) {
+		record.lFrames.push_back(gCapturedFrames[frame]);
+	}
+	gPendingCrashes.push_back(record);
+	fArm();
+}
+
+void crashHandling::fReportCrashes() {
+	if (gPendingCrashes.empty()) {
+		return;
+	}
+	std::vector<void*> unresolved;
+	for (auto& crash : gPendingCrashes) {
+		for (auto frame : crash.lFrames) {
+			if (gSymbolCache.find(frame) == gSymbolCache.end()) {
+				unresolved.push_back(frame);
+				// Mark as queued, so it is only looked up once.
+				gSymbolCache[frame];
+			}
+		}
+	}
+	symbolize(unresolved);
+
+	for (auto& crash : gPendingCrashes) {
+		errorHandling::setContext(&crash.lTestName, &crash.lClassName);
+		bool reported = errorHandling::throwError(crash.lDeclFileName.c_str(), 0, errorHandling::kError,
+		                TString::Format("Test '%s' crashed for class '%s' with signal %d (%s), backtrace:",
+		                                crash.lTestName.c_str(), crash.lClassName.c_str(),
+		                                crash.lSignal, strsignal(crash.lSignal)));
+		// The trace belongs to the crash, it is suppressed along with it.
+		for (std::size_t frame = 0; reported && frame < crash.lFrames.size(); ++frame) {
+			errorHandling::throwError(crash.lDeclFileName.c_str(), 0, errorHandling::kNotice,
+			                          TString::Format("#%zu %p in %s", frame, crash.lFrames[frame],
+			                                  gSymbolCache[crash.lFrames[frame]].c_str()), kFALSE);
+		}
+		errorHandling::setContext(nullptr, nullptr);
+	}
+	gPendingCrashes.clear();
+}
@@ -4,7 +4,63 @@
 
 #include <TSystem.h>
 #include <TPRegexp.h>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <map>
+#include <mutex>
+#include <unordered_set>
+
+namespace {
+	// Diagnostics may come from several test threads, the context is per thread, everything else is locked.
+	thread_local const std::string* gContextTest = nullptr;
+	thread_local const std::string* gContextClass = nullptr;
+	std::mutex gErrorMutex;
+
+	std::unordered_set<ULong64_t> gBaseline;
+	std::size_t gSuppressedCount = 0;
+
+	errorHandling::diagnosticListener gDiagnosticListener;
+
+	std::string gBaselineOutputFile;
+	std::map<ULong64_t, std::string> gRecordedDiagnostics; //< Fingerprint => readable description, sorted for stable files.
+
+	const ULong64_t kFnvOffset = 14695981039346656037ULL;
+	const ULong64_t kFnvPrime  = 1099511628211ULL;
+
+	ULong64_t fnvAppend(ULong64_t aHash, char aChar) {
+		return (aHash ^ static_cast<unsigned char>(aChar)) * kFnvPrime;
+	}
+
+	ULong64_t fnvAppend(ULong64_t aHash, const char* aString) {
+		for (; *aString != '\0'; ++aString) {
+			aHash = fnvAppend(aHash, *aString);
+		}
+		// Separator, so "ab"+"c" differs from "a"+"bc".
+		return fnvAppend(aHash, '\0');
+	}
+
+	// Numbers (also hex like 0x7f00) vary between runs and machines, mask them to get a message template.
+	// Digits inside identifiers (e.g. member 'fX1') are kept.
+	std::string maskNumbers(const char* aMessage) {
+		std::string masked;
+		for (const char* c = aMessage; *c != '\0'; ++c) {
+			bool inIdentifier = !masked.empty() && (isalnum(static_cast<unsigned char>(masked.back())) || masked.back() == '_');
+			if (!isdigit(static_cast<unsigned char>(*c)) || inIdentifier) {
+				masked += *c;
+				continue;
+			}
+			if (c[0] == '0' && c[1] == 'x') {
+				for (++c; isxdigit(static_cast<unsigned char>(c[1])); ++c) { }
+			} else {
+				for (; isdigit(static_cast<unsigned char>(c[1])) || c[1] == '.'; ++c) { }
+			}
+			masked += '#';
+		}
+		return masked;
+	}
+}
 
 void errorHandling::throwErrorInternal(const char* file, Int_t line, errorType errType, const char* message) {
 	std::cerr << file << ":" << line << ": ";
@@ -22,15 +78,108 @@ void errorHandling::throwErrorInternal(const char* file, Int_t line, errorType e
 			break;
 	}
 	std::cerr << message << std::endl;
+	if (gDiagnosticListener) {
+		gDiagnosticListener(errType, file, line, message, gContextTest, gContextClass);
+	}
+}
+
+void errorHandling::setDiagnosticListener(diagnosticListener listener) {
+	std::lock_guard<std::mutex> lock(gErrorMutex);
+	gDiagnosticListener = listener;
+}
+
+void errorHandling::setContext(const std::string* testName, const std::string* className) {
+	gContextTest = testName;
+	gContextClass = className;
 }
 
-Bool_t errorHandling::throwError(const char* file, Int_t line, errorType errType, const char* message) {
+ULong64_t errorHandling::getFingerprint(errorType errType, const char* message) {
+	ULong64_t hash = kFnvOffset;
+	hash = fnvAppend(hash, (gContextTest != nullptr) ? gContextTest->c_str() : "");
+	hash = fnvAppend(hash, (gContextClass != nullptr) ? gContextClass->c_str() : "");
+	hash = fnvAppend(hash, static_cast<char>('0' + errType));
+	hash = fnvAppend(hash, maskNumbers(message).c_str());
+	return hash;
+}
+
+Bool_t errorHandling::isInBaseline(errorType errType, const char* message) {
+	if (gBaseline.empty() && gBaselineOutputFile.empty()) {
+		return kFALSE;
+	}
+	auto fingerprint = getFingerprint(errType, message);
+	if (!gBaselineOutputFile.empty()) {
+		auto& description = gRecordedDiagnostics[fingerprint];
+		if (description.empty()) {
+			description = TString::Format("%s | %s | %s",
+			                              (gContextTest != nullptr) ? gContextTest->c_str() : "-",
+			                              (gContextClass != nullptr) ? gContextClass->c_str() : "-",
+			                              maskNumbers(message).c_str()).Data();
+		}
+	}
+	if (gBaseline.find(fingerprint) != gBaseline.end()) {
+		gSuppressedCount++;
+		return kTRUE;
+	}
+	return kFALSE;
+}
+
+Bool_t errorHandling::loadBaseline(const char* baselineFile) {
+	std::ifstream input(baselineFile);
+	if (!input) {
+		return kFALSE;
+	}
+	std::string line;
+	while (std::getline(input, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		char* end = nullptr;
+		auto fingerprint = strtoull(line.c_str(), &end, 16);
+		if (end != line.c_str()) {
+			gBaseline.insert(fingerprint);
+		}
+	}
+	return kTRUE;
+}
+
+void errorHandling::recordBaseline(const char* baselineFile) {
+	gBaselineOutputFile = baselineFile;
+}
+
+Bool_t errorHandling::writeBaseline() {
+	if (gBaselineOutputFile.empty()) {
+		return kTRUE;
+	}
+	std::ofstream output(gBaselineOutputFile);
+	if (!output) {
+		return kFALSE;
+	}
+	output << "# rootStaticAnalyzer baseline: fingerprint, then test | class | message (numbers masked)." << std::endl;
+	for (auto& diagnostic : gRecordedDiagnostics) {
+		output << TString::Format("%016llx", diagnostic.first) << "\t" << diagnostic.second << std::endl;
+	}
+	return static_cast<bool>(output);
+}
+
+std::size_t errorHandling::getSuppressedCount() {
+	return gSuppressedCount;
+}
+
+Bool_t errorHandling::throwError(const char* file, Int_t line, errorType errType, const char* message, Bool_t useBaseline) {
+	std::lock_guard<std::mutex> lock(gErrorMutex);
+	if (useBaseline && isInBaseline(errType, message)) {
+		return kFALSE;
+	}
 	const TString& fileName = utilityFunctions::performPathLookup(file, kTRUE);
 	throwErrorInternal(fileName.Data(), line, errType, message);
 	return kTRUE;
 }
 
 Bool_t errorHandling::throwError(const char* file, TPRegexp& lineMatcher, errorType errType, const char* message) {
+	std::lock_guard<std::mutex> lock(gErrorMutex);
+	if (isInBaseline(errType, message)) {
+		return kFALSE;
+	}
 	const TString& fileName = utilityFunctions::performPathLookup(file, kTRUE);
 	Int_t lineNo = 0;
 	if (gSystem->AccessPathName(fileName.Data()) == kFALSE) {
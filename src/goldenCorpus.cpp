@@ -0,0 +1,268 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "goldenCorpus.h"
+
+#include <cstring>
+#include <fstream>
+
+#include <unistd.h>
+
+namespace {
+	const char kMagic[8] = {'R', 'S', 'A', 'G', 'O', 'L', 'D', '\0'};
+	const UInt_t kByteOrderMark = 0x01020304;
+
+	void writePadding(std::ofstream& aOutput, std::size_t aLength) {
+		static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+		aOutput.write(zeros, (8 - aLength % 8) % 8);
+	}
+}
+
+struct goldenCorpus::fileHeader {
+	char lMagic[8];
+	UInt_t lFormatVersion;
+	UInt_t lByteOrder;
+};
+
+struct goldenCorpus::indexRecord {
+	ULong64_t lOffset;    //< Of the payload, from the start of the file.
+	ULong64_t lChecksum;
+	UInt_t lLength;
+	UInt_t lName;         //< Offset in the string pool of this section.
+	Short_t lVersion;
+	Short_t lPadding;
+	UInt_t lPadding2;
+};
+
+struct goldenCorpus::fileFooter {
+	ULong64_t lIndexOffset;
+	UInt_t lEntryCount;
+	UInt_t lStringPoolSize;  //< Including padding, the pool directly follows the index.
+	char lMagic[8];
+};
+
+static_assert(sizeof(goldenCorpus::fileHeader) % 8 == 0, "Records need to keep 8-byte alignment.");
+static_assert(sizeof(goldenCorpus::indexRecord) % 8 == 0, "Records need to keep 8-byte alignment.");
+static_assert(sizeof(goldenCorpus::fileFooter) % 8 == 0, "Records need to keep 8-byte alignment.");
+
+ULong64_t goldenCorpus::fChecksum(const char* aBytes, std::size_t aLength) {
+	// FNV-1a, we only need to detect changes, not resist attacks.
+	ULong64_t hash = 14695981039346656037ULL;
+	for (std::size_t i = 0; i < aLength; ++i) {
+		hash ^= static_cast<UChar_t>(aBytes[i]);
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+bool goldenCorpus::fOpen(const std::string& aPath) {
+	lIndex = nullptr;
+	lEntryCount = 0;
+	lValidEnd = 0;
+	if (!lFile.fOpen(aPath) || lFile.fGetSize() < sizeof(fileHeader)) {
+		return false;
+	}
+	auto header = reinterpret_cast<const fileHeader*>(lFile.fGetData());
+	if (memcmp(header->lMagic, kMagic, sizeof(kMagic)) != 0
+	        || header->lFormatVersion != kFormatVersion
+	        || header->lByteOrder != kByteOrderMark) {
+		return false;
+	}
+	// Sections keep 8-byte alignment, so do footers. Usually the first candidate is the one.
+	auto size = lFile.fGetSize();
+	if (size >= sizeof(fileHeader) + sizeof(fileFooter)) {
+		for (ULong64_t offset = (size - sizeof(fileFooter)) / 8 * 8; offset >= sizeof(fileHeader); offset -= 8) {
+			if (fUseFooter(offset)) {
+				lValidEnd = offset + sizeof(fileFooter);
+				return true;
+			}
+		}
+	}
+	// The very first append was interrupted, only the header can be kept.
+	lValidEnd = sizeof(fileHeader);
+	return false;
+}
+
+bool goldenCorpus::fUseFooter(ULong64_t aFooterOffset) {
+	auto data = lFile.fGetData();
+	auto footer = reinterpret_cast<const fileFooter*>(data + aFooterOffset);
+	if (memcmp(footer->lMagic, kMagic, sizeof(kMagic)) != 0) {
+		return false;
+	}
+	ULong64_t expectedEnd = footer->lIndexOffset
+	                        + static_cast<ULong64_t>(footer->lEntryCount) * sizeof(indexRecord)
+	                        + footer->lStringPoolSize;
+	if (footer->lIndexOffset < sizeof(fileHeader) || footer->lIndexOffset % 8 != 0 || expectedEnd != aFooterOffset) {
+		return false;
+	}
+	lIndex = reinterpret_cast<const indexRecord*>(data + footer->lIndexOffset);
+	lEntryCount = footer->lEntryCount;
+	lStrings = data + footer->lIndexOffset + static_cast<ULong64_t>(footer->lEntryCount) * sizeof(indexRecord);
+	lStringPoolSize = footer->lStringPoolSize;
+	if (!fValidate()) {
+		lIndex = nullptr;
+		lEntryCount = 0;
+		return false;
+	}
+	return true;
+}
+
+bool goldenCorpus::fValidate() const {
+	if (lStringPoolSize == 0 || lStrings[lStringPoolSize - 1] != '\0') {
+		// Then every offset inside the pool is a terminated string.
+		return false;
+	}
+	// Payloads always precede the index pointing to them.
+	ULong64_t indexOffset = reinterpret_cast<const char*>(lIndex) - lFile.fGetData();
+	for (UInt_t i = 0; i < lEntryCount; ++i) {
+		auto& record = lIndex[i];
+		if (record.lName >= lStringPoolSize
+		        || record.lOffset < sizeof(fileHeader)
+		        || record.lOffset + record.lLength > indexOffset) {
+			return false;
+		}
+		if (i > 0 && strcmp(fGetName(i - 1), fGetName(i)) >= 0) {
+			// fFind() relies on the order.
+			return false;
+		}
+	}
+	return true;
+}
+
+const char* goldenCorpus::fGetName(std::size_t aEntry) const {
+	return lStrings + lIndex[aEntry].lName;
+}
+
+std::size_t goldenCorpus::fFind(const std::string& aClassName) const {
+	std::size_t low = 0;
+	std::size_t high = lEntryCount;
+	while (low < high) {
+		auto middle = low + (high - low) / 2;
+		auto comparison = strcmp(fGetName(middle), aClassName.c_str());
+		if (comparison == 0) {
+			return middle;
+		} else if (comparison < 0) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+	return lEntryCount;
+}
+
+goldenCorpus::entry goldenCorpus::fGetEntry(std::size_t aEntry) const {
+	auto& record = lIndex[aEntry];
+	return entry{lFile.fGetData() + record.lOffset, record.lLength, record.lChecksum, record.lVersion};
+}
+
+void goldenCorpus::fStage(const std::string& aClassName, Version_t aVersion, const char* aBytes, std::size_t aLength) {
+	auto& staged = lStaged[aClassName];
+	staged.lBytes.assign(aBytes, aBytes + aLength);
+	staged.lChecksum = fChecksum(aBytes, aLength);
+	staged.lVersion = aVersion;
+}
+
+Long64_t goldenCorpus::fCommit(const std::string& aPath) {
+	bool appending = lValidEnd > 0;
+	if (!appending && std::ifstream(aPath).good()) {
+		// Unreadable or foreign, appending would bury it for good.
+		return -1;
+	}
+
+	// Name -> record (name offset still unset), starting from the current index.
+	std::map<std::string, indexRecord> records;
+	for (std::size_t i = 0; i < lEntryCount; ++i) {
+		records[fGetName(i)] = lIndex[i];
+	}
+
+	// Cut a torn tail, the new section then directly follows the last intact one.
+	ULong64_t fileEnd = appending ? lValidEnd : sizeof(fileHeader);
+	if (appending && lFile.fGetSize() != lValidEnd && truncate(aPath.c_str(), lValidEnd) != 0) {
+		return -1;
+	}
+	std::ofstream output(aPath, std::ios::binary | std::ios::app);
+	if (!appending) {
+		fileHeader header;
+		memset(&header, 0, sizeof(header));
+		memcpy(header.lMagic, kMagic, sizeof(kMagic));
+		header.lFormatVersion = kFormatVersion;
+		header.lByteOrder = kByteOrderMark;
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	}
+
+	Long64_t payloadsWritten = 0;
+	for (auto& staged : lStaged) {
+		auto known = records.find(staged.first);
+		if (known != records.end()
+		        && known->second.lChecksum == staged.second.lChecksum
+		        && known->second.lLength == staged.second.lBytes.size()) {
+			// Same bytes, at most the version was bumped.
+			known->second.lVersion = staged.second.lVersion;
+			continue;
+		}
+		indexRecord record;
+		memset(&record, 0, sizeof(record));
+		record.lOffset   = fileEnd;
+		record.lChecksum = staged.second.lChecksum;
+		record.lLength   = staged.second.lBytes.size();
+		record.lVersion  = staged.second.lVersion;
+		records[staged.first] = record;
+
+		output.write(staged.second.lBytes.data(), staged.second.lBytes.size());
+		writePadding(output, staged.second.lBytes.size());
+		fileEnd += (staged.second.lBytes.size() + 7) / 8 * 8;
+		++payloadsWritten;
+	}
+
+	// Empty string at offset 0 keeps the pool non-empty and terminated.
+	std::string pool(1, '\0');
+	std::vector<indexRecord> index;
+	index.reserve(records.size());
+	for (auto& record : records) {
+		record.second.lName = pool.size();
+		pool.append(record.first.c_str(), record.first.size() + 1);
+		index.push_back(record.second);
+	}
+	pool.resize((pool.size() + 7) / 8 * 8, '\0');
+
+	fileFooter footer;
+	memset(&footer, 0, sizeof(footer));
+	footer.lIndexOffset    = fileEnd;
+	footer.lEntryCount     = index.size();
+	footer.lStringPoolSize = pool.size();
+	memcpy(footer.lMagic, kMagic, sizeof(kMagic));
+
+	output.write(reinterpret_cast<const char*>(index.data()), index.size() * sizeof(indexRecord));
+	output.write(pool.data(), pool.size());
+	output.write(reinterpret_cast<const char*>(&footer), sizeof(footer));
+	output.close();
+	if (!output) {
+		// E.g. disk full: do not leave a tail without footer behind.
+		if (appending) {
+			(void) truncate(aPath.c_str(), lValidEnd);
+		} else {
+			unlink(aPath.c_str());
+		}
+		return -1;
+	}
+
+	lStaged.clear();
+	// Re-map, so further lookups see the new section.
+	fOpen(aPath);
+	return payloadsWritten;
+}
@@ -0,0 +1,128 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __analyzerCore_h__
+#define __analyzerCore_h__
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Rtypes.h>
+
+#include "classObject.h"
+#include "errorHandling.h"
+
+class TClass;
+
+// In-process entry point of librootStaticAnalyzerCore, for frameworks checking the classes of their own job.
+// Classes are registered by TClass, no rootmaps are scanned and no libraries are loaded.
+//
+// ROOT is used from the thread executing the tests. While running in the background, the host must not use ROOT
+// concurrently unless ROOT::EnableThreadSafety() was called. The replacement of operator new is only linked into
+// the executable, so ConstructionLeaks skips all classes when embedded. Installing crashHandling is up to the host.
+// Only one analyzerCore may exist at a time, it receives the diagnostics and results of all tests while it exists.
+class analyzerCore {
+  public:
+	struct diagnostic {
+		errorHandling::errorType lType;
+		std::string lFile;
+		Int_t lLine;
+		std::string lMessage;
+	};
+
+	struct testResult {
+		std::string lTestName;
+		std::string lClassName;
+		classObject::testStatus lStatus;
+		Double_t lNs;
+		std::vector<diagnostic> lDiagnostics; //< Issued while this test ran on this class.
+		// Diagnostics issued after the result was delivered, i.e. symbolized crash reports (issued in batches
+		// after each round of tests): at the end of the run, the callback receives them in a second record for the
+		// same test and class with only these diagnostics. In fGetResults() they are appended to the original result.
+		bool lSupplement;
+	};
+
+	// Called once per test and class as soon as the result is known (plus supplements), never concurrently.
+	typedef std::function<void(const testResult&)> resultCallback;
+
+  protected:
+	std::vector<TClass*> lClasses;
+	std::vector<std::string> lTestNamePatterns;
+	std::vector<std::string> lTestNameAntiPatterns;
+	resultCallback lCallback;
+	typedef std::pair<std::string, std::string> testAndClass;
+
+	std::vector<testResult> lResults;
+	std::map<testAndClass, std::size_t> lResultIndex;  //< Into lResults.
+	std::mutex lResultMutex;  //< Serializes lCallback, lResults and lResultIndex.
+	// Diagnostics by the test and class context they were issued in, not yet handed out with a result.
+	std::map<testAndClass, std::vector<diagnostic>> lPendingDiagnostics;
+	std::mutex lPendingMutex;
+	std::atomic<bool> lRunning;
+	std::thread lWorker;
+	bool lDebug;
+
+	// Runs the tests, lRunning must already be claimed by the caller.
+	std::size_t fExecute();
+	void fOnDiagnostic(const diagnostic& aDiagnostic, const std::string& aTestName, const std::string& aClassName);
+	void fOnResult(const std::string& aTestName, const std::string& aClassName, classObject::testStatus aStatus, Double_t aNs);
+	// Hands out the diagnostics which arrived after their results, as supplements.
+	void fDeliverSupplements();
+
+  public:
+	analyzerCore(bool aDebug = false);
+	~analyzerCore();
+	analyzerCore(const analyzerCore&) = delete;
+	analyzerCore& operator=(const analyzerCore&) = delete;
+
+	// Adds a class to be checked. Returns false if it was registered before or a run is ongoing.
+	bool fRegisterClass(TClass* aClass);
+
+	// Regular expressions on the test names as for the executable, no patterns select all tests.
+	// As there, tests whose prerequisite tests are not selected find nothing to do, e.g. "^Streaming$" alone runs
+	// nothing, "^ConstructionDestruction$" needs to be selected as well.
+	void fSelectTests(const std::vector<std::string>& aTestNamePatterns, const std::vector<std::string>& aTestNameAntiPatterns);
+
+	void fSetResultCallback(resultCallback aCallback);
+
+	// Runs the selected tests on all registered classes, returns the number of test executions or 0 if
+	// another run is ongoing. Results of earlier runs are discarded.
+	std::size_t fRun();
+
+	// As fRun(), on a separate thread. Returns false if another run is ongoing.
+	bool fRunInBackground();
+
+	// Blocks until a background run has finished.
+	void fWait();
+
+	bool fIsRunning() const {
+		return lRunning;
+	}
+
+	// All results of the last run, valid while no run is ongoing.
+	const std::vector<testResult>& fGetResults() const {
+		return lResults;
+	}
+};
+
+#endif /* __analyzerCore_h__ */
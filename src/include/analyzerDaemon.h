@@ -0,0 +1,98 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __analyzerDaemon_h__
+#define __analyzerDaemon_h__
+
+#include <string>
+#include <vector>
+
+#include <Rtypes.h>
+
+#include "classObject.h"
+
+// Keeps ROOT and all materialized classes warm and serves test-requests on a unix domain socket.
+//
+// A request is a sequence of lines, terminated by "run":
+//   class <regexp>      select classes (default: all classes the daemon was started with)
+//   anticlass <regexp>  deselect classes
+//   test <regexp>       select tests (default: all)
+//   antitest <regexp>   deselect tests
+//   run                 execute the request
+// or the single line "quit" to stop the daemon.
+//
+// The answer consists of tab-separated lines:
+//   diagnostic <line>                       errors / warnings / notes issued while testing
+//   result <class> <test> <status>          one per selected class and test, results are cached across requests
+//   stale <library>                         library changed on disk since it was loaded
+//   restart                                 daemon re-executes itself to pick up changed libraries, the answer follows
+//   done <classes> <tests>                  end of answer
+//   error <message>
+//
+// On a restart, the cached results of classes from unchanged libraries and the pending request are handed over
+// to the new process in a state file next to the socket, together with the still open connection. Only the process
+// re-executed by the daemon (marked via the environment) takes it over, any other start removes a left-over state file.
+class analyzerDaemon {
+  public:
+	enum connectionAction {
+		kContinue,
+		kRestart,
+		kQuit
+	};
+
+  protected:
+	classTable& lClasses;
+	std::string lSocketPath;
+	bool lDebug;
+
+	std::vector<std::string> lLibraries;   //< Full paths of all libraries providing tested classes.
+	std::vector<Long_t> lLibraryMTimes;    //< Modification time of the libraries when they were loaded.
+	std::vector<UInt_t> lClassLibraries;   //< Per row of lClasses: index into lLibraries.
+
+	static const UInt_t kNoLibrary = static_cast<UInt_t>(-1);
+
+	struct request {
+		std::vector<std::string> lClassPatterns;
+		std::vector<std::string> lClassAntiPatterns;
+		std::vector<std::string> lTestPatterns;
+		std::vector<std::string> lTestAntiPatterns;
+	};
+
+	void fCollectLibraries();
+	bool fLibraryChanged(UInt_t aLibrary) const;
+	// Reads a request into aRequest and answers it.
+	connectionAction fHandleConnection(int aFd, request& aRequest);
+	// Runs the request and answers it, or returns kRestart (without an answer) if libraries of requested classes changed.
+	connectionAction fAnswerRequest(int aFd, const request& aRequest);
+
+	std::string fGetStatePath() const {
+		return lSocketPath + ".state";
+	}
+	// Hands the cached results of classes from unchanged libraries, the request and its connection over to the next process.
+	bool fWriteState(int aFd, const request& aRequest);
+	// Takes over what fWriteState() left, returns the connection (-1 if there is none) and the pending request.
+	int fReadState(request& aRequest);
+
+  public:
+	analyzerDaemon(classTable& aClasses, const std::string& aSocketPath, bool aDebug);
+
+	// Serves requests until "quit" was received. aArgv is needed to re-execute ourselves.
+	int fServe(char** aArgv);
+};
+
+#endif /* __analyzerDaemon_h__ */
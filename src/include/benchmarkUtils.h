@@ -0,0 +1,52 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __benchmarkUtils_h__
+#define __benchmarkUtils_h__
+
+#include <chrono>
+#include <cstddef>
+#include <limits>
+
+#include <Rtypes.h>
+
+namespace benchmarkUtils {
+	// Nanoseconds per call of aCallable, minimum over aRepetitions runs of aIterations calls each.
+	// Taking the minimum filters out scheduler noise, we are interested in the cost of the code path.
+	template <typename Callable>
+	Double_t nsPerCall(std::size_t aIterations, Callable aCallable, std::size_t aRepetitions = 5) {
+		if (aIterations == 0) {
+			return 0.;
+		}
+		Double_t bestNs = std::numeric_limits<Double_t>::max();
+		for (std::size_t rep = 0; rep < aRepetitions; ++rep) {
+			auto start = std::chrono::steady_clock::now();
+			for (std::size_t i = 0; i < aIterations; ++i) {
+				aCallable();
+			}
+			auto stop = std::chrono::steady_clock::now();
+			Double_t ns = std::chrono::duration<Double_t, std::nano>(stop - start).count() / aIterations;
+			if (ns < bestNs) {
+				bestNs = ns;
+			}
+		}
+		return bestNs;
+	}
+};
+
+#endif /* __benchmarkUtils_h__ */
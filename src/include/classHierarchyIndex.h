@@ -0,0 +1,92 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __classHierarchyIndex_h__
+#define __classHierarchyIndex_h__
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <Rtypes.h>
+
+class TClass;
+
+// Inheritance index over all materialized classes (and their bases).
+// Each class gets a dense ID, each class which is a base of another class additionally gets a column
+// in a bitset-matrix holding the transitive bases per class. Inheritance queries are then a single bit-test.
+class classHierarchyIndex {
+  public:
+	static const UInt_t kInvalidId = static_cast<UInt_t>(-1);
+
+  protected:
+	std::vector<TClass*> lClasses;                           //< Dense ID => TClass.
+	std::vector<std::vector<UInt_t>> lDirectBases;           //< Dense ID => dense IDs of direct bases.
+	std::vector<UInt_t> lBaseColumns;                        //< Dense ID => column in lBaseBits, kInvalidId if never a base.
+	std::vector<ULong64_t> lBaseBits;                        //< Row per dense ID, bit set for each (transitive) base.
+	std::size_t lWordsPerRow = 0;
+	std::unordered_map<const TClass*, UInt_t> lIdsByClass;
+	std::unordered_map<std::string, UInt_t> lIdsByName;
+
+	UInt_t fAssignIds(TClass* aClass);
+	void fFillRow(UInt_t aId, std::vector<bool>& aDone);
+
+  public:
+	// Build the index from the given classes, their bases are added automatically.
+	void fBuild(const std::vector<TClass*>& aClasses);
+
+	bool fIsBuilt() const {
+		return !lClasses.empty();
+	}
+
+	UInt_t fGetId(const TClass* aClass) const;
+	UInt_t fGetId(const std::string& aClassName) const;
+
+	TClass* fGetClass(UInt_t aId) const {
+		return lClasses[aId];
+	}
+
+	// Whether aId inherits from (or is) aBaseId.
+	bool fInheritsFrom(UInt_t aId, UInt_t aBaseId) const {
+		if (aId == kInvalidId || aBaseId == kInvalidId) {
+			return false;
+		}
+		if (aId == aBaseId) {
+			return true;
+		}
+		auto column = lBaseColumns[aBaseId];
+		if (column == kInvalidId) {
+			return false;
+		}
+		return (lBaseBits[aId * lWordsPerRow + column / 64] >> (column % 64)) & 1;
+	}
+
+	// Falls back to TClass::InheritsFrom() for classes not part of the index.
+	bool fInheritsFrom(const TClass* aClass, const TClass* aBase) const;
+	bool fInheritsFrom(const TClass* aClass, const char* aBaseName) const;
+
+	// All indexed classes inheriting from (or being) aBase.
+	std::vector<TClass*> fGetSubclasses(const TClass* aBase) const;
+
+	static classHierarchyIndex& fGetIndex() {
+		static classHierarchyIndex lIndex;
+		return lIndex;
+	};
+};
+
+#endif /* __classHierarchyIndex_h__ */
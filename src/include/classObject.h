@@ -19,70 +19,233 @@
 #ifndef __classObject_h__
 #define __classObject_h__
 
-#include <map>
+#include <memory>
 #include <string>
+#include <vector>
+#include <unordered_map>
+
+#include <Rtypes.h>
+
+#include "reflectionSnapshot.h"
 
 class TClass;
+class classTable;
 
+// Lightweight handle to one class stored in a classTable.
 class classObject {
-  protected:
-	TClass* lClass;         //< Underlying TClass.
-	std::string lClassName; //< Name of underlying class.
-	bool lInheritsTObject;  //< Inherits from TObject.
-	bool lIsDataObject;     //< DataObject (TObjects with class version not <= 0).
-	bool lHasNew;           //< Whether New() is useable.
-	bool lHasDelete;        //< Whether Destructor() is useable.
-	bool lHasDefaultConstructor; //< Whether there is a real default constructor. 
+  public:
+	enum testStatus : UChar_t {
+		kNotRun = 0,
+		kPassed,
+		kFailed,
+		kSkipped,
+		kCrashed,
+		kTimeout
+	};
 
-	std::map<std::string, bool> lTestedFeatures;
+  protected:
+	classTable* lTable;  //< Table holding the data of this class.
+	std::size_t lIndex;  //< Row in the table.
 
   public:
-	classObject(TClass* aClass);
+	classObject(classTable& aTable, std::size_t aIndex) : lTable{&aTable}, lIndex{aIndex} { };
 
 	bool operator<( const classObject& other ) const {
-		return (lClassName) < (other.lClassName);
+		return fGetClassName() < other.fGetClassName();
 	};
 
-	TClass* fGetTClass() const {
-		return lClass;
+	std::size_t fGetIndex() const {
+		return lIndex;
 	}
 
-	std::string fGetClassName() const {
-		return lClassName;
+	static const char* fGetStatusName(testStatus aTestStatus) {
+		switch (aTestStatus) {
+			case kNotRun:
+				return "not-run";
+			case kPassed:
+				return "passed";
+			case kFailed:
+				return "failed";
+			case kSkipped:
+				return "skipped";
+			case kCrashed:
+				return "crashed";
+			case kTimeout:
+				return "timeout";
+			default:
+				return "unknown";
+		}
 	}
 
-	bool fHasNew() const {
-		return lHasNew;
-	}
-	bool fHasDefaultConstructor() const {
-		return lHasDefaultConstructor;
+	inline TClass* fGetTClass() const;
+	inline const std::string& fGetClassName() const;
+
+	inline bool fHasNew() const;
+	inline bool fHasDefaultConstructor() const;
+	inline bool fHasDelete() const;
+	inline bool fInheritsTObject() const;
+	inline bool fIsDataObject () const;
+	inline bool fIsFromSnapshotFile() const;
+
+	// Built on first request, tests running in parallel need it to be built beforehand.
+	inline const reflectionSnapshot& fGetSnapshot() const;
+
+	inline testStatus fGetTestStatus(std::size_t aTestId) const;
+	inline bool fWasTested(std::size_t aTestId) const;
+	inline void fMarkTested(std::size_t aTestId, testStatus aTestStatus);
+	inline void fMarkTested(std::size_t aTestId, bool aTestResult);
+	inline bool fWasTestedSuccessfully(std::size_t aTestId) const;
+};
+
+// Struct-of-arrays storage of all classes under test and their test states.
+// Test states are kept as one byte per class and test, indexed by the dense test-IDs of testInterface.
+class classTable {
+  public:
+	enum classFlags : UChar_t {
+		kInheritsTObject       = 1 << 0, //< Inherits from TObject.
+		kIsDataObject          = 1 << 1, //< DataObject (TObjects with class version not <= 0).
+		kHasNew                = 1 << 2, //< Whether New() is useable.
+		kHasDelete             = 1 << 3, //< Whether Destructor() is useable.
+		kHasDefaultConstructor = 1 << 4, //< Whether there is a real default constructor.
+		kFromSnapshotFile      = 1 << 5  //< Read from a snapshot file, there is no TClass.
+	};
+
+	static const std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+	class iterator {
+	  protected:
+		classTable* lTable;
+		std::size_t lIndex;
+	  public:
+		iterator(classTable* aTable, std::size_t aIndex) : lTable{aTable}, lIndex{aIndex} { };
+		classObject operator*() const {
+			return classObject(*lTable, lIndex);
+		}
+		iterator& operator++() {
+			++lIndex;
+			return *this;
+		}
+		bool operator!=(const iterator& other) const {
+			return lIndex != other.lIndex;
+		}
+	};
+
+  protected:
+	std::vector<TClass*> lClasses;                       //< Underlying TClasses.
+	std::vector<UInt_t> lNameIds;                        //< Per class: index into lNames.
+	std::vector<UChar_t> lFlags;                         //< Per class: classFlags.
+	std::vector<UChar_t> lTestStatus;                    //< Per class: lTestColumns entries of classObject::testStatus.
+	std::vector<std::unique_ptr<const reflectionSnapshot>> lSnapshots; //< Per class: reflection snapshot, nullptr until requested.
+	std::size_t lTestColumns;
+
+	std::vector<std::string> lNames;                     //< Interned class names.
+	std::unordered_map<std::string, UInt_t> lNameLookup; //< Name => index into lNames.
+	std::vector<std::size_t> lRowsByNameId;              //< Index into lNames => row.
+
+	void fAddName(const std::string& aClassName, std::size_t aIndex);
+	void fResizeTestColumns(std::size_t aTestColumns);
+	const reflectionSnapshot& fBuildSnapshot(std::size_t aIndex);
+
+	friend class classObject;
+
+  public:
+	classTable(std::size_t aTestColumns = 0) : lTestColumns{aTestColumns} { };
+
+	// Adds a class and determines its flags, returns its row.
+	std::size_t fAddClass(TClass* aClass);
+	// Adds a class known only from a snapshot file, with the flags stored there.
+	std::size_t fAddSnapshot(std::unique_ptr<const reflectionSnapshot> aSnapshot, UChar_t aFlags);
+
+	UChar_t fGetFlags(std::size_t aIndex) const {
+		return lFlags[aIndex];
 	}
-	bool fHasDelete() const {
-		return lHasDelete;
+	bool fHasSnapshot(std::size_t aIndex) const {
+		return static_cast<bool>(lSnapshots[aIndex]);
 	}
 
-	bool fInheritsTObject() const {
-		return lInheritsTObject;
-	}
+	std::size_t fFindClass(const std::string& aClassName) const;
 
-	bool fIsDataObject () const {
-		return lIsDataObject;
+	std::size_t size() const {
+		return lClasses.size();
 	}
-
-	bool fWasTested(std::string aTestName) const {
-		return (lTestedFeatures.find(aTestName) != lTestedFeatures.end());
+	bool empty() const {
+		return lClasses.empty();
 	}
-	void fMarkTested(std::string aTestName, bool aTestResult) {
-		lTestedFeatures[aTestName] = aTestResult;
+	classObject operator[](std::size_t aIndex) {
+		return classObject(*this, aIndex);
 	}
-	bool fWasTestedSuccessfully(std::string aTestName) const {
-		auto testRes = lTestedFeatures.find(aTestName);
-		if (testRes == lTestedFeatures.end()) {
-			return false;
-		} else {
-			return testRes->second;
-		}
+	iterator begin() {
+		return iterator(this, 0);
+	}
+	iterator end() {
+		return iterator(this, lClasses.size());
 	}
 };
 
+TClass* classObject::fGetTClass() const {
+	return lTable->lClasses[lIndex];
+}
+
+const std::string& classObject::fGetClassName() const {
+	return lTable->lNames[lTable->lNameIds[lIndex]];
+}
+
+bool classObject::fHasNew() const {
+	return lTable->lFlags[lIndex] & classTable::kHasNew;
+}
+
+bool classObject::fHasDefaultConstructor() const {
+	return lTable->lFlags[lIndex] & classTable::kHasDefaultConstructor;
+}
+
+bool classObject::fHasDelete() const {
+	return lTable->lFlags[lIndex] & classTable::kHasDelete;
+}
+
+bool classObject::fInheritsTObject() const {
+	return lTable->lFlags[lIndex] & classTable::kInheritsTObject;
+}
+
+bool classObject::fIsDataObject() const {
+	return lTable->lFlags[lIndex] & classTable::kIsDataObject;
+}
+
+const reflectionSnapshot& classObject::fGetSnapshot() const {
+	auto& snapshot = lTable->lSnapshots[lIndex];
+	if (snapshot) {
+		return *snapshot;
+	}
+	return lTable->fBuildSnapshot(lIndex);
+}
+
+bool classObject::fIsFromSnapshotFile() const {
+	return lTable->lFlags[lIndex] & classTable::kFromSnapshotFile;
+}
+
+classObject::testStatus classObject::fGetTestStatus(std::size_t aTestId) const {
+	if (aTestId >= lTable->lTestColumns) {
+		return kNotRun;
+	}
+	return static_cast<testStatus>(lTable->lTestStatus[lIndex * lTable->lTestColumns + aTestId]);
+}
+
+bool classObject::fWasTested(std::size_t aTestId) const {
+	return fGetTestStatus(aTestId) != kNotRun;
+}
+
+void classObject::fMarkTested(std::size_t aTestId, testStatus aTestStatus) {
+	if (aTestId >= lTable->lTestColumns) {
+		lTable->fResizeTestColumns(aTestId + 1);
+	}
+	lTable->lTestStatus[lIndex * lTable->lTestColumns + aTestId] = aTestStatus;
+}
+
+void classObject::fMarkTested(std::size_t aTestId, bool aTestResult) {
+	fMarkTested(aTestId, aTestResult ? kPassed : kFailed);
+}
+
+bool classObject::fWasTestedSuccessfully(std::size_t aTestId) const {
+	return fGetTestStatus(aTestId) == kPassed;
+}
+
 #endif /* __classObject_h__ */
@@ -0,0 +1,46 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __crashHandling_h__
+#define __crashHandling_h__
+
+#include <string>
+
+// Fast crash backtraces: instead of ROOT's stacktrace (which usually launches gdb for every crash),
+// a signal handler in front of ROOT's only records the raw frames. Symbolization is deferred until
+// fReportCrashes(), done in one batch for all collected crashes and cached across them.
+class crashHandling {
+  public:
+	// Installs our handler for SIGSEGV, SIGBUS, SIGILL and SIGFPE, chaining to the handlers installed before.
+	// Needs to be called after ROOT has installed its signal handlers (i.e. after creating the TApplication).
+	static void fInstall();
+
+	// Forget frames captured so far, call before running a test.
+	static void fArm();
+
+	// Whether a crash was captured since the last fArm().
+	static bool fCrashCaptured();
+
+	// Store the frames captured since the last fArm() for the given test and class.
+	static void fCollectCrash(const std::string& aTestName, const std::string& aClassName, const char* aDeclFileName);
+
+	// Symbolize and report all collected crashes.
+	static void fReportCrashes();
+};
+
+#endif /* __crashHandling_h__ */
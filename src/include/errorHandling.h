@@ -19,6 +19,9 @@
 #ifndef __errorHandling_h__
 #define __errorHandling_h__
 
+#include <functional>
+#include <string>
+
 #include <Rtypes.h>
 #include <TPRegexp.h>
 
@@ -29,11 +32,34 @@ class errorHandling {
 		kWarning,
 		kNotice
 	};
+	// Receives every reported diagnostic with the test and class context of the reporting thread (nullptr if unset).
+	// Called with the diagnostics lock held, so calls are serialized.
+	typedef std::function<void(errorType errType, const char* file, Int_t line, const char* message,
+	                            const std::string* testName, const std::string* className)> diagnosticListener;
   private:
 	static void throwErrorInternal(const char* file, Int_t line, errorType errType, const char* message);
+	static Bool_t isInBaseline(errorType errType, const char* message);
   public:
-	static Bool_t throwError(const char* file, Int_t line, errorType errType, const char* message);
+	// Both return kFALSE if the diagnostic was suppressed (baseline or ignore-marker).
+	// Follow-up lines of another diagnostic (e.g. backtraces) should not be baselined on their own.
+	static Bool_t throwError(const char* file, Int_t line, errorType errType, const char* message, Bool_t useBaseline = kTRUE);
 	static Bool_t throwError(const char* file, TPRegexp& lineMatcher, errorType errType, const char* message);
+
+	// Test and class the following diagnostics (of this thread) belong to, part of their fingerprint. Pass nullptr to clear.
+	static void setContext(const std::string* testName, const std::string* className);
+
+	// Diagnostics are still printed. Pass an empty function to remove the listener.
+	static void setDiagnosticListener(diagnosticListener listener);
+
+	// Stable fingerprint of a diagnostic: test, class, type and the message with all numbers masked.
+	static ULong64_t getFingerprint(errorType errType, const char* message);
+
+	// Known diagnostics from the baseline are not reported anymore.
+	static Bool_t loadBaseline(const char* baselineFile);
+	// Remember all diagnostics of this run and write them as a fresh baseline at the end.
+	static void recordBaseline(const char* baselineFile);
+	static Bool_t writeBaseline();
+	static std::size_t getSuppressedCount();
 };
 
 #endif /* __errorHandling_h__ */
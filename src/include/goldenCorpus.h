@@ -0,0 +1,98 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __goldenCorpus_h__
+#define __goldenCorpus_h__
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <Rtypes.h>
+
+#include "mappedFile.h"
+
+// Append-only file of streamed default objects, read via mmap.
+// Layout: header, then one section per commit: payload blobs, index records sorted by class name, string pool, footer.
+// The footer at the end of the file locates the newest index, which covers all classes ever stored.
+// An interrupted append leaves a tail without footer, the newest intact footer is used then and the tail is cut on commit.
+// Unchanged payloads are not written again, their index records point into older sections.
+class goldenCorpus {
+  public:
+	static const UInt_t kFormatVersion = 1;
+
+	struct fileHeader;
+	struct indexRecord;
+	struct fileFooter;
+
+	struct entry {
+		const char* lBytes;
+		UInt_t lLength;
+		ULong64_t lChecksum;
+		Version_t lVersion;
+	};
+
+  protected:
+	struct stagedEntry {
+		std::vector<char> lBytes;
+		ULong64_t lChecksum;
+		Version_t lVersion;
+	};
+
+	mappedFile lFile;
+	const indexRecord* lIndex = nullptr;
+	UInt_t lEntryCount = 0;
+	const char* lStrings = nullptr;
+	UInt_t lStringPoolSize = 0;
+	std::map<std::string, stagedEntry> lStaged;
+	ULong64_t lValidEnd = 0; //< End of the intact part of the file, 0 if the file is missing or foreign.
+
+	const char* fGetName(std::size_t aEntry) const;
+	bool fUseFooter(ULong64_t aFooterOffset);
+	bool fValidate() const;
+
+  public:
+	static ULong64_t fChecksum(const char* aBytes, std::size_t aLength);
+
+	// Maps the file and locates the newest index, falling back to older footers if the end of the file is torn.
+	// Fails for missing or foreign files and for files without any intact section.
+	bool fOpen(const std::string& aPath);
+	bool fIsOpen() const {
+		return lIndex != nullptr;
+	}
+
+	std::size_t fGetEntryCount() const {
+		return lEntryCount;
+	}
+	const char* fGetClassName(std::size_t aEntry) const {
+		return fGetName(aEntry);
+	}
+	// Index of the class' entry (binary search in the mapped index), or fGetEntryCount() if unknown.
+	std::size_t fFind(const std::string& aClassName) const;
+	entry fGetEntry(std::size_t aEntry) const;
+
+	// Remembers the payload of a class for the next fCommit().
+	void fStage(const std::string& aClassName, Version_t aVersion, const char* aBytes, std::size_t aLength);
+	// Appends a new section with the staged payloads which differ from the opened corpus and an index of all classes.
+	// Creates the file if it does not exist yet, but never overwrites a file whose header fOpen() did not accept.
+	// A torn tail is cut before appending, and a failed append is cut again, so the file always ends with a footer.
+	// Returns the number of payloads written, or -1 on error.
+	Long64_t fCommit(const std::string& aPath);
+};
+
+#endif /* __goldenCorpus_h__ */
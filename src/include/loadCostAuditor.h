@@ -0,0 +1,74 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __loadCostAuditor_h__
+#define __loadCostAuditor_h__
+
+#include <iosfwd>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <Rtypes.h>
+
+class TClass;
+
+// Measures the first materialization of classes (TClass::GetClass() with autoloading), i.e. wall time,
+// growth of the resident set, libraries loaded on the way and headers / payloads parsed by the interpreter
+// (autoparsing, counted from TCling's messages with gDebug raised while materializing).
+// Costs are attributed to classes and to the libraries providing them.
+class loadCostAuditor {
+  protected:
+	struct classCost {
+		std::string lClassName;
+		std::string lLibrary;                   //< First library listed for the class, "" if unknown.
+		Double_t lSeconds = 0;
+		Long_t lResidentKB = 0;
+		std::vector<std::string> lLoadedLibraries;
+		std::size_t lAutoparseEvents = 0;       //< Headers or payloads parsed while materializing.
+		bool lAutoparsed = false;
+		bool lFound = false;
+	};
+	struct libraryCost {
+		std::string lLibrary;
+		Double_t lSeconds = 0;
+		Long_t lResidentKB = 0;
+		std::size_t lClasses = 0;
+		std::size_t lLoadedLibraries = 0;
+		std::size_t lAutoparsed = 0;
+	};
+
+	std::vector<classCost> lClassCosts;
+	std::set<std::string> lLoadedLibraries;
+	bool lStarted = false;
+
+	static Long_t fGetResidentKB();
+	static std::set<std::string> fGetLoadedLibraries();
+
+  public:
+	static const std::size_t kReportEntries = 25; //< Entries per ranking, unless the full report is requested.
+
+	// Materializes the class like TClass::GetClass(aClassName, kTRUE) and records the costs.
+	TClass* fGetClass(const std::string& aClassName);
+
+	// Rankings per class and per library, most expensive first.
+	void fReport(std::ostream& aStream, bool aFull) const;
+};
+
+#endif /* __loadCostAuditor_h__ */
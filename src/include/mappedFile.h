@@ -0,0 +1,53 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __mappedFile_h__
+#define __mappedFile_h__
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file, unmapped on destruction.
+class mappedFile {
+  protected:
+	const char* lData = nullptr;
+	std::size_t lSize = 0;
+
+  public:
+	mappedFile() = default;
+	mappedFile(const mappedFile&) = delete;
+	mappedFile& operator=(const mappedFile&) = delete;
+	~mappedFile() {
+		fClose();
+	}
+
+	bool fOpen(const std::string& aPath);
+	void fClose();
+
+	bool fIsOpen() const {
+		return lData != nullptr;
+	}
+	const char* fGetData() const {
+		return lData;
+	}
+	std::size_t fGetSize() const {
+		return lSize;
+	}
+};
+
+#endif /* __mappedFile_h__ */
@@ -0,0 +1,49 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __memoryUtils_h__
+#define __memoryUtils_h__
+
+#include <cstddef>
+
+#include <Rtypes.h>
+
+namespace memoryUtils {
+	// Net allocations (allocated minus freed) while counting was enabled.
+	struct allocationCounters {
+		Long64_t lBytes;
+		Long64_t lBlocks;
+	};
+
+	// Bytes currently allocated from the heap (all arenas, including mmapped chunks).
+	std::size_t getHeapInUse();
+
+	// The counting hook replaces the global operator new / delete, it is only part of the executable.
+	bool isAllocationHookInstalled();
+	void markAllocationHookInstalled();
+
+	// Enabling resets the counters.
+	void setAllocationCounting(bool aEnable);
+	allocationCounters getAllocationCounters();
+
+	// Called by the hook.
+	void countAllocation(void* aPtr);
+	void countDeallocation(void* aPtr);
+};
+
+#endif /* __memoryUtils_h__ */
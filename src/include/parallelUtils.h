@@ -0,0 +1,78 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __parallelUtils_h__
+#define __parallelUtils_h__
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace parallelUtils {
+	// Calls aCallable(index) for all indices in [0, aCount) on aThreads threads.
+	// Each thread starts on its own contiguous share and takes chunks from its front,
+	// threads which are done steal chunks from the others, so expensive classes do not stall the run.
+	template<typename Callable> void forEachIndex(std::size_t aCount, unsigned int aThreads, Callable aCallable) {
+		const std::size_t chunkSize = 16;
+		if (aThreads <= 1 || aCount <= chunkSize) {
+			for (std::size_t i = 0; i < aCount; ++i) {
+				aCallable(i);
+			}
+			return;
+		}
+
+		struct share {
+			std::atomic<std::size_t> lNext;
+			std::size_t lEnd;
+		};
+		std::unique_ptr<share[]> shares(new share[aThreads]);
+		for (unsigned int t = 0; t < aThreads; ++t) {
+			shares[t].lNext = aCount * t / aThreads;
+			shares[t].lEnd = aCount * (t + 1) / aThreads;
+		}
+
+		auto worker = [&](unsigned int aOwnShare) {
+			for (unsigned int s = 0; s < aThreads; ++s) {
+				auto& current = shares[(aOwnShare + s) % aThreads];
+				for (;;) {
+					auto begin = current.lNext.fetch_add(chunkSize);
+					if (begin >= current.lEnd) {
+						break;
+					}
+					auto end = std::min(begin + chunkSize, current.lEnd);
+					for (auto i = begin; i < end; ++i) {
+						aCallable(i);
+					}
+				}
+			}
+		};
+
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < aThreads; ++t) {
+			threads.emplace_back(worker, t);
+		}
+		worker(0);
+		for (auto& thread : threads) {
+			thread.join();
+		}
+	}
+};
+
+#endif /* __parallelUtils_h__ */
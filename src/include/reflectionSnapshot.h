@@ -0,0 +1,134 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __reflectionSnapshot_h__
+#define __reflectionSnapshot_h__
+
+#include <string>
+#include <vector>
+
+#include <Rtypes.h>
+
+class TClass;
+class TRealData;
+
+// Immutable copy of the reflection data of one class, built once and shared by all tests.
+// Reading it needs no TList / TIter and no ROOT locks, so parallel tests can use it freely.
+// Snapshots read back from a snapshot file (see snapshotFile) have no ROOT objects attached:
+// the TClass, TRealData and owner pointers are nullptr and there are no streamer elements.
+class reflectionSnapshot {
+  public:
+	static const Int_t kNoDataType = -1;
+
+	// Flattened real data: members of the class, its bases and (with dotted names) of its object members.
+	struct member {
+		TRealData* lRealData;     //< Realdata describing the member, for diagnostics.
+		std::string lName;        //< Realdata name, e.g. "fPos.fX" for a member of a member.
+		std::string lMemberName;  //< Name of the data member itself, e.g. "fX".
+		std::string lTypeName;
+		TClass* lOwner;           //< Class declaring the member.
+		std::string lOwnerName;
+		Version_t lOwnerVersion;
+		Long_t lOffset;           //< Offset in the object.
+		Int_t lUnitSize;          //< Size of a single element.
+		Int_t lElements;          //< Number of elements of fixed size arrays, 1 otherwise.
+		Int_t lDataType;          //< EDataType of basic members, kNoDataType otherwise.
+		std::string lArrayIndex;  //< Size-member of a variable array (//[fN]), empty otherwise.
+		bool lTransient;
+		bool lIsObject;
+		bool lIsPointer;
+		bool lIsBasic;
+		bool lIsPersistent;
+		bool lIsNested;           //< Member of one of our members.
+		bool lHasRange;           //< Range / precision given in the comment (Double32_t, Float16_t).
+	};
+
+	struct baseClass {
+		TClass* lClass;
+		std::string lName;
+		Int_t lOffset;
+		Version_t lVersion;
+	};
+
+	struct streamerElement {
+		std::string lName;
+		std::string lTypeName;
+		Int_t lType;
+		Int_t lOffset;
+		Int_t lSize;
+		Int_t lArrayLength;
+		bool lIsBase;
+	};
+
+  protected:
+	TClass* lClass;
+	std::string lClassName;
+	std::string lDeclFileName;
+	UInt_t lSize;
+	Version_t lClassVersion;
+	UInt_t lCheckSum;
+	bool lHasCustomStreamerMember;
+	std::vector<member> lMembers;
+	std::vector<baseClass> lBases;
+	std::vector<streamerElement> lStreamerElements; //< Of the current streamer info, only for versioned classes.
+
+	reflectionSnapshot() : lClass{nullptr}, lSize{0}, lClassVersion{0}, lCheckSum{0}, lHasCustomStreamerMember{false} { };
+
+	friend class snapshotFile;
+
+  public:
+	// Builds the real data of the class (and its streamer info) if not done yet.
+	explicit reflectionSnapshot(TClass* aClass);
+
+	TClass* fGetTClass() const {
+		return lClass;
+	}
+	const std::string& fGetClassName() const {
+		return lClassName;
+	}
+	const char* fGetDeclFileName() const {
+		return lDeclFileName.c_str();
+	}
+	UInt_t fGetSize() const {
+		return lSize;
+	}
+	// Storage for placement-construction of an object, in UInt_t (with one spare).
+	std::size_t fGetArenaUInts() const {
+		return lSize / sizeof(UInt_t) + 1;
+	}
+	Version_t fGetClassVersion() const {
+		return lClassVersion;
+	}
+	UInt_t fGetCheckSum() const {
+		return lCheckSum;
+	}
+	bool fHasCustomStreamerMember() const {
+		return lHasCustomStreamerMember;
+	}
+	const std::vector<member>& fGetMembers() const {
+		return lMembers;
+	}
+	const std::vector<baseClass>& fGetBases() const {
+		return lBases;
+	}
+	const std::vector<streamerElement>& fGetStreamerElements() const {
+		return lStreamerElements;
+	}
+};
+
+#endif /* __reflectionSnapshot_h__ */
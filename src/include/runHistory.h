@@ -0,0 +1,48 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __runHistory_h__
+#define __runHistory_h__
+
+#include <string>
+#include <vector>
+
+#include <Rtypes.h>
+
+#include "classObject.h"
+
+// Per-class, per-test durations and outcomes of earlier runs, kept in a local text file.
+// Used to order the classes of the next run: previous failures first (regressions show up early),
+// then longest processing time first (slow classes do not stretch the end of the run).
+class runHistory {
+  public:
+	// Reads the history file, a missing file is an empty history. Returns false only if it exists but can not be read.
+	static bool fLoad(const std::string& aPath);
+
+	// Remember the result of one test on one class for fWrite(). Thread-safe, does nothing unless a history was loaded.
+	static void fRecord(const std::string& aTestName, const std::string& aClassName, Double_t aNs, classObject::testStatus aStatus);
+
+	// Writes the loaded history, updated with everything recorded in this run.
+	static bool fWrite(const std::string& aPath);
+
+	// All rows of the table, failed classes first, then by total duration (descending).
+	// Classes without history are assumed to take the mean duration of the known ones.
+	static std::vector<std::size_t> fOrderRows(classTable& aClasses);
+};
+
+#endif /* __runHistory_h__ */
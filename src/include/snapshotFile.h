@@ -0,0 +1,78 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __snapshotFile_h__
+#define __snapshotFile_h__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <Rtypes.h>
+
+#include "mappedFile.h"
+#include "reflectionSnapshot.h"
+
+class classTable;
+
+// Versioned flat file of reflection snapshots, read via mmap.
+// Layout: header, library records, class records, member records, base records, string pool.
+// All records are fixed-size and 8-byte aligned, strings are offsets into the NUL-separated pool.
+// Each class refers to the library providing it, identified by path, size and modification time:
+// classes whose library changed since the file was written are stale and must not be used.
+class snapshotFile {
+  public:
+	static const UInt_t kFormatVersion = 1;
+
+	struct fileHeader;
+	struct libraryRecord;
+	struct classRecord;
+	struct memberRecord;
+	struct baseRecord;
+
+  protected:
+	mappedFile lFile;
+	const fileHeader* lHeader = nullptr;
+	const libraryRecord* lLibraries = nullptr;
+	const classRecord* lClasses = nullptr;
+	const memberRecord* lMembers = nullptr;
+	const baseRecord* lBases = nullptr;
+	const char* lStrings = nullptr;
+	std::vector<bool> lLibraryUpToDate;
+
+	const char* fGetString(UInt_t aOffset) const {
+		return lStrings + aOffset;
+	}
+	bool fValidate() const;
+
+  public:
+	// Writes all classes of the table which have a snapshot (and a TClass), returns the number of classes written.
+	static std::size_t fWrite(const std::string& aPath, classTable& aClasses);
+
+	// Maps the file and checks format and bounds, then checks which libraries are unchanged.
+	bool fOpen(const std::string& aPath);
+
+	std::size_t fGetClassCount() const;
+	const char* fGetClassName(std::size_t aClass) const;
+	const char* fGetLibraryPath(std::size_t aClass) const;
+	bool fIsUpToDate(std::size_t aClass) const;
+	UChar_t fGetClassFlags(std::size_t aClass) const;
+	std::unique_ptr<const reflectionSnapshot> fGetSnapshot(std::size_t aClass) const;
+};
+
+#endif /* __snapshotFile_h__ */
@@ -20,15 +20,35 @@
 #define __streamingUtils_h__
 
 #include <map>
+#include <vector>
+#include <random>
 
 #include "TMD5.h"
 #include "TString.h"
 class TRealData;
 class TObject;
+class TClass;
+class TBufferFile;
+class reflectionSnapshot;
 
 namespace streamingUtils {
+	// Basic member which can be filled with random values without breaking streaming.
+	struct fuzzableMember {
+		TRealData* lRealData; //< Realdata describing the member.
+		Long_t lOffset;       //< Offset in the object.
+		Int_t lUnitSize;      //< Size of a single element.
+		Int_t lElements;      //< Number of elements (fixed size arrays).
+		Int_t lDataType;      //< EDataType of the elements.
+	};
+
+	// Streams obj to the start of buf (which needs to be in write-mode).
+	void streamObjectToBuffer(TBufferFile& buf, TObject* obj);
+	TString checksumBuffer(TBufferFile& buf);
 	TString streamObjectToBufferAndChecksum(TObject* obj);
-	std::map<TString, std::pair<TMD5, TRealData*>> getRealDataDigests(TObject* obj);
+	std::map<TString, std::pair<TMD5, TRealData*>> getRealDataDigests(TObject* obj, const reflectionSnapshot& snapshot);
+
+	std::vector<fuzzableMember> getFuzzableMembers(const reflectionSnapshot& snapshot);
+	void randomizeMembers(void* obj, const std::vector<fuzzableMember>& members, std::mt19937_64& rng);
 };
 
 #endif /* __streamingUtils_h__ */
@@ -23,22 +23,61 @@
 #include <vector>
 #include <string>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+
+#include <TClass.h>
+#include <TException.h>
+#include <TROOT.h>
+#include <RVersion.h>
 
 #include "classObject.h"
+#include "crashHandling.h"
+#include "errorHandling.h"
+#include "parallelUtils.h"
+#include "runHistory.h"
 
 class testInterface {
+  public:
+	struct testSettings {
+		bool lBenchmark = false;            //< Whether tests should also run their (slow) benchmarks.
+		std::size_t lIterations = 100000;   //< Number of calls per timed loop in benchmarks.
+		std::size_t lFuzzRoundTrips = 1000; //< Streaming round-trips with random member values per class.
+		unsigned int lThreads = 1;          //< Threads for reflection-only tests.
+		std::vector<std::string> lReferenceFiles; //< ROOT files whose stored streamer infos are compared with the live classes.
+		std::string lGoldenCorpus;          //< Corpus of streamed default objects to compare with.
+		std::string lWriteGoldenCorpus;     //< Corpus to append the streamed default objects of this run to.
+	};
+
+	// Receives the outcome of each test on each class. Tests running in parallel call it from several threads at once.
+	typedef std::function<void(const testInterface& aTest, classObject& aClass, classObject::testStatus aStatus, Double_t aNs)> resultListener;
+
   private:
 	static std::map<std::string, testInterface*>& fGetTestMap() {
 		static std::map<std::string, testInterface*> lTestSet;
 		return lTestSet;
 	};
 
+	static std::map<std::string, std::size_t>& fGetTestIdMap() {
+		static std::map<std::string, std::size_t> lTestIds;
+		return lTestIds;
+	};
+
 	static void fRegisterTest(std::string& aTest, testInterface* aThis) {
 		fGetTestMap()[aTest] = aThis;
 	}
 
+	// Set by fMarkTimedOut() during the current fRunTest() of this thread.
+	static bool& fGetTimedOut() {
+		static thread_local bool lTimedOut = false;
+		return lTimedOut;
+	}
+
   protected:
 	std::string lTestName;
+	std::size_t lTestId;
 
 	virtual bool fCheckPrerequisites(classObject& /*aClass*/) {
 		return true;
@@ -46,16 +85,138 @@ class testInterface {
 
 	virtual bool fRunTest(classObject& /*aClass*/) = 0;
 
+	// For fRunTest() giving up on a class which did not finish in time: its status becomes kTimeout (instead of kFailed).
+	static void fMarkTimedOut() {
+		fGetTimedOut() = true;
+	}
+
+	void fReportResult(classObject& aClass, classObject::testStatus aStatus, Double_t aNs) {
+		runHistory::fRecord(fGetTestName(), aClass.fGetClassName(), aNs, aStatus);
+		auto& listener = fGetResultListener();
+		if (listener) {
+			listener(*this, aClass, aStatus, aNs);
+		}
+	}
+
+	static bool fCanRunParallel() {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+		return fGetSettings().lThreads > 1;
+#else
+		return false;
+#endif
+	}
+
+	// Single-threaded pre-warm of everything reflection-only tests may touch, then switch ROOT to thread-safe mode.
+	// Building a snapshot runs dictionary code, so it is protected as in the serial path: rows crashing
+	// are marked as crashed for this test and removed from aRows. Returns the number of those.
+	std::size_t fPrepareParallelRun(classTable& allClasses, std::vector<std::size_t>& aRows) {
+		std::vector<std::size_t> preparedRows;
+		preparedRows.reserve(aRows.size());
+		std::size_t crashedRows = 0;
+		for (auto row : aRows) {
+			auto cls = allClasses[row];
+			volatile bool crashed = false;
+			errorHandling::setContext(&fGetTestName(), &cls.fGetClassName());
+			crashHandling::fArm();
+			TRY {
+				cls.fGetSnapshot();
+			} CATCH ( excode ) {
+				(void) excode;
+				crashed = true;
+			}
+			ENDTRY;
+			if (crashHandling::fCrashCaptured()) {
+				crashHandling::fCollectCrash(fGetTestName(), cls.fGetClassName(),
+				                             cls.fIsFromSnapshotFile() ? cls.fGetSnapshot().fGetDeclFileName() : cls.fGetTClass()->GetDeclFileName());
+			}
+			errorHandling::setContext(nullptr, nullptr);
+			if (crashed) {
+				cls.fMarkTested(lTestId, classObject::kCrashed);
+				fReportResult(cls, classObject::kCrashed, 0.);
+				crashedRows++;
+			} else {
+				preparedRows.push_back(row);
+			}
+		}
+		aRows.swap(preparedRows);
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+		static bool threadSafetyEnabled = false;
+		if (!threadSafetyEnabled) {
+			ROOT::EnableThreadSafety();
+			threadSafetyEnabled = true;
+		}
+#endif
+		return crashedRows;
+	}
+
+	std::size_t fRunTestInParallel(classTable& allClasses, const std::vector<std::size_t>* aRows, bool debug) {
+		// Prerequisites only read other tests' columns, collect the work serially.
+		std::vector<std::size_t> rows;
+		std::size_t count = (aRows != nullptr) ? aRows->size() : allClasses.size();
+		for (std::size_t i = 0; i < count; ++i) {
+			auto row = (aRows != nullptr) ? (*aRows)[i] : i;
+			auto cls = allClasses[row];
+			if (!cls.fWasTested(lTestId) && fCheckPrerequisites(cls)) {
+				rows.push_back(row);
+			}
+		}
+		auto crashedRows = fPrepareParallelRun(allClasses, rows);
+		std::mutex debugMutex;
+		// Each row has its own status cell, so marking results needs no lock.
+		parallelUtils::forEachIndex(rows.size(), fGetSettings().lThreads, [&](std::size_t aIndex) {
+			auto cls = allClasses[rows[aIndex]];
+			errorHandling::setContext(&fGetTestName(), &cls.fGetClassName());
+			fGetTimedOut() = false;
+			auto start = std::chrono::steady_clock::now();
+			bool result = fRunTest(cls);
+			auto stop = std::chrono::steady_clock::now();
+			errorHandling::setContext(nullptr, nullptr);
+			if (!result && fGetTimedOut()) {
+				cls.fMarkTested(lTestId, classObject::kTimeout);
+			} else {
+				cls.fMarkTested(lTestId, result);
+			}
+			fReportResult(cls, cls.fGetTestStatus(lTestId), std::chrono::duration<Double_t, std::nano>(stop - start).count());
+			if (debug) {
+				std::lock_guard<std::mutex> lock(debugMutex);
+				std::cout << fGetTestName() << ": Tested  " << cls.fGetClassName() << " => " << (result ? "good" : "FAIL") << std::endl;
+			}
+		});
+		return rows.size() + crashedRows;
+	}
+
   public:
-	testInterface(std::string aTestName) : lTestName{aTestName} {
+	testInterface(std::string aTestName) : lTestName{aTestName}, lTestId{fGetTestId(aTestName)} {
 		fRegisterTest(lTestName, this);
 	};
 	virtual ~testInterface() = default;
 
-	virtual std::size_t fRunTestOnClasses(std::vector<classObject>& allClasses, bool debug = false) {
+	// Tests only reading reflection data (no user code, no construction) can run on many threads.
+	// They run without crash protection (TRY / CATCH is not thread-safe) and must only call thread-safe ROOT methods
+	// on data which is prepared by fPrepareParallelRun(). Tests using nothing but the reflection snapshot
+	// also run on classes read from a snapshot file.
+	virtual bool fIsReflectionOnly() const {
+		return false;
+	}
+
+	// Called once after all tests ran, for tests collecting results across classes.
+	virtual void fFinalize() {
+	}
+
+	virtual std::size_t fRunTestOnClasses(classTable& allClasses, bool debug = false) {
+		return fRunTestOnSelection(allClasses, nullptr, debug);
+	}
+
+	// Runs the test on the given rows of the table only, or on all rows if aRows is nullptr.
+	virtual std::size_t fRunTestOnSelection(classTable& allClasses, const std::vector<std::size_t>* aRows, bool debug = false) {
+		if (fIsReflectionOnly() && fCanRunParallel()) {
+			return fRunTestInParallel(allClasses, aRows, debug);
+		}
 		std::size_t testsRun = 0;
-		for (auto& cls : allClasses) {
-			if (cls.fWasTested(fGetTestName())) {
+		std::size_t count = (aRows != nullptr) ? aRows->size() : allClasses.size();
+		for (std::size_t i = 0; i < count; ++i) {
+			auto cls = allClasses[(aRows != nullptr) ? (*aRows)[i] : i];
+			if (cls.fWasTested(lTestId)) {
 				// We already tested this.
 				continue;
 			}
@@ -63,10 +224,37 @@ class testInterface {
 				if (debug) {
 					std::cout << fGetTestName() << ": Testing " << cls.fGetClassName() << std::endl;
 				}
-				bool result = fRunTest(cls);
-				cls.fMarkTested(fGetTestName(), result);
+				volatile bool result = false;
+				volatile bool crashed = false;
+				errorHandling::setContext(&fGetTestName(), &cls.fGetClassName());
+				fGetTimedOut() = false;
+				crashHandling::fArm();
+				auto start = std::chrono::steady_clock::now();
+				TRY {
+					result = fRunTest(cls);
+				} CATCH ( excode ) {
+					(void) excode;
+					crashed = true;
+				}
+				ENDTRY;
+				auto stop = std::chrono::steady_clock::now();
+				if (crashHandling::fCrashCaptured()) {
+					// Also if the test survived the crash, the trace is interesting.
+					crashHandling::fCollectCrash(fGetTestName(), cls.fGetClassName(),
+					                             cls.fIsFromSnapshotFile() ? cls.fGetSnapshot().fGetDeclFileName() : cls.fGetTClass()->GetDeclFileName());
+				}
+				errorHandling::setContext(nullptr, nullptr);
+				if (crashed) {
+					cls.fMarkTested(lTestId, classObject::kCrashed);
+				} else if (!result && fGetTimedOut()) {
+					cls.fMarkTested(lTestId, classObject::kTimeout);
+				} else {
+					cls.fMarkTested(lTestId, static_cast<bool>(result));
+				}
+				fReportResult(cls, cls.fGetTestStatus(lTestId), std::chrono::duration<Double_t, std::nano>(stop - start).count());
 				if (debug) {
-					std::cout << fGetTestName() << ": Tested  " << cls.fGetClassName() << " => " << (result ? "good" : "FAIL") << std::endl;
+					std::cout << fGetTestName() << ": Tested  " << cls.fGetClassName() << " => "
+					          << (crashed ? "CRASH" : (result ? "good" : "FAIL")) << std::endl;
 				}
 				testsRun++;
 			}
@@ -74,13 +262,64 @@ class testInterface {
 		return testsRun;
 	}
 
-	virtual std::string fGetTestName() const {
+	// Runs the given tests until none of them finds anything left to do (tests may depend on each other).
+	static std::size_t fRunTests(classTable& allClasses, const std::vector<testInterface*>& aTests,
+	                             const std::vector<std::size_t>* aRows, bool debug = false) {
+		std::size_t allTestsRun = 0;
+		std::size_t executedTests = 0;
+		do {
+			executedTests = 0;
+			for (auto test : aTests) {
+				auto testsRun = test->fRunTestOnSelection(allClasses, aRows, debug);
+				std::cout << test->fGetTestName() << ": " << testsRun << std::endl;
+				executedTests += testsRun;
+			}
+			// Symbolize all crashes of this round in one go.
+			crashHandling::fReportCrashes();
+			allTestsRun += executedTests;
+		} while (executedTests > 0);
+		return allTestsRun;
+	}
+
+	virtual const std::string& fGetTestName() const {
 		return lTestName;
 	}
 
+	std::size_t fGetId() const {
+		return lTestId;
+	}
+
+	// Dense ID of a test by name, IDs are handed out on first request (usually at registration).
+	// Resolve once and keep the ID, the lookup itself is not meant for hot loops.
+	static std::size_t fGetTestId(const std::string& aTestName) {
+		auto& testIds = fGetTestIdMap();
+		auto known = testIds.find(aTestName);
+		if (known != testIds.end()) {
+			return known->second;
+		}
+		auto id = testIds.size();
+		testIds[aTestName] = id;
+		return id;
+	}
+
+	static std::size_t fGetTestIdCount() {
+		return fGetTestIdMap().size();
+	}
+
 	static const std::map<std::string, testInterface*>& fGetAllTests() {
 		return fGetTestMap();
 	};
+
+	static testSettings& fGetSettings() {
+		static testSettings lSettings;
+		return lSettings;
+	};
+
+	// Empty by default. Not to be changed while tests are running.
+	static resultListener& fGetResultListener() {
+		static resultListener lListener;
+		return lListener;
+	};
 };
 
 #endif /* __testInterface_h__ */
@@ -20,22 +20,46 @@
 #define __utilityFunctions_h__
 
 #include <TString.h>
+#include <map>
 #include <string>
 #include <set>
+#include <vector>
+
+class testInterface;
+class TClass;
 
 namespace utilityFunctions {
+	// One declaration of a class in a rootmap.
+	struct rootmapRegistration {
+		std::string lRootmap;                 //< Path of the rootmap.
+		Int_t lLine;                          //< Line of the declaration.
+		std::vector<std::string> lLibraries;  //< Loaded when autoloading the class, the providing library first.
+	};
+	// Class name => all its registrations, in the order the rootmaps were read.
+	typedef std::multimap<std::string, rootmapRegistration> rootmapRegistry;
+
 	TString searchInIncludePath(const char* aFileName, Bool_t aStripRootIncludePath);
 	TString performPathLookup(const char* file, Bool_t aRemoveRootIncludePath = kFALSE);
 
-	void parseRootmap(const char* aFilename, std::set<std::string>& classNames);
+	void parseRootmap(const char* aFilename, rootmapRegistry& aRegistry);
 
 	TString getRootLibDir();
 
-	std::set<std::string> getRootmapsByRegexps(const std::vector<std::string>& rootMapPatterns, bool debug);
+	// Full path of the library providing the class (first entry of its shared libs), empty if unknown.
+	std::string getProvidingLibraryPath(TClass* aClass);
+
+	rootmapRegistry getRootmapsByRegexps(const std::vector<std::string>& rootMapPatterns, bool debug);
+	std::set<std::string> getClassNames(const rootmapRegistry& aRegistry);
+	// Reports classes registered more than once (and whether the registrations conflict) and, per list of libraries,
+	// how many extra libraries autoloading pulls in. Returns the number of duplicate or conflicting classes.
+	std::size_t checkRootmapRegistrations(const rootmapRegistry& aRegistry);
 	void filterSetByPatterns(std::set<std::string>& allClasses,
 	                         const std::vector<std::string>& classNamePatterns,
 	                         const std::vector<std::string>& classNameAntiPatterns,
 	                         bool debug);
+	std::vector<testInterface*> selectTestsByPatterns(const std::vector<std::string>& testNamePatterns,
+	                                                  const std::vector<std::string>& testNameAntiPatterns,
+	                                                  bool debug);
 };
 
 #endif /* __utilityFunctions_h__ */
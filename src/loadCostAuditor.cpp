@@ -0,0 +1,177 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "loadCostAuditor.h"
+
+#include <TClass.h>
+#include <TError.h>
+#include <TString.h>
+#include <TSystem.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string.h>
+
+namespace {
+	std::size_t gAutoparseEvents = 0;
+	ErrorHandlerFunc_t gPreviousErrorHandler = nullptr;
+	Int_t gPreviousIgnoreLevel = 0;
+
+	// Counts the headers / payloads TCling parses (reported as Info with gDebug > 0). All other Info messages
+	// are chatter caused by the raised gDebug and are dropped right away (neither formatted further nor printed,
+	// which would end up in the measured time), warnings and errors go where they would have gone anyway.
+	void countAutoparseHandler(int aLevel, Bool_t aAbort, const char* aLocation, const char* aMessage) {
+		if (aLevel < kWarning) {
+			if (aLocation != nullptr && strncmp(aLocation, "TCling::AutoParse", 17) == 0
+			        && aMessage != nullptr && strstr(aMessage, "Parsing ") != nullptr) {
+				gAutoparseEvents++;
+			}
+			return;
+		}
+		if (aLevel >= gPreviousIgnoreLevel && gPreviousErrorHandler != nullptr) {
+			gPreviousErrorHandler(aLevel, aAbort, aLocation, aMessage);
+		}
+	}
+}
+
+Long_t loadCostAuditor::fGetResidentKB() {
+	ProcInfo_t info;
+	if (gSystem->GetProcInfo(&info) != 0) {
+		return 0;
+	}
+	return info.fMemResident;
+}
+
+std::set<std::string> loadCostAuditor::fGetLoadedLibraries() {
+	std::set<std::string> libraries;
+	std::istringstream libraryList(gSystem->GetLibraries());
+	std::string library;
+	while (libraryList >> library) {
+		libraries.insert(library);
+	}
+	return libraries;
+}
+
+TClass* loadCostAuditor::fGetClass(const std::string& aClassName) {
+	classCost cost;
+	cost.lClassName = aClassName;
+	if (!lStarted) {
+		lLoadedLibraries = fGetLoadedLibraries();
+		lStarted = true;
+	}
+
+	// TCling only announces autoparsing with gDebug > 0, catch those messages during this materialization.
+	// Everything is switched before the clock starts and back after it stopped, what remains inside is ROOT
+	// formatting its debug messages, which is small compared to loading libraries or parsing headers.
+	gAutoparseEvents = 0;
+	gPreviousIgnoreLevel = gErrorIgnoreLevel;
+	gPreviousErrorHandler = SetErrorHandler(countAutoparseHandler);
+	gErrorIgnoreLevel = kInfo;
+	auto previousDebug = gDebug;
+	gDebug = std::max(gDebug, 1);
+
+	auto residentBefore = fGetResidentKB();
+	auto start = std::chrono::steady_clock::now();
+	auto cls = TClass::GetClass(aClassName.c_str(), kTRUE);
+	auto stop = std::chrono::steady_clock::now();
+
+	gDebug = previousDebug;
+	gErrorIgnoreLevel = gPreviousIgnoreLevel;
+	SetErrorHandler(gPreviousErrorHandler);
+	cost.lAutoparseEvents = gAutoparseEvents;
+	cost.lAutoparsed = gAutoparseEvents > 0;
+	cost.lSeconds = std::chrono::duration<Double_t>(stop - start).count();
+	cost.lResidentKB = fGetResidentKB() - residentBefore;
+
+	auto librariesNow = fGetLoadedLibraries();
+	std::set_difference(librariesNow.begin(), librariesNow.end(),
+	                    lLoadedLibraries.begin(), lLoadedLibraries.end(),
+	                    std::back_inserter(cost.lLoadedLibraries));
+	lLoadedLibraries.swap(librariesNow);
+
+	if (cls != nullptr) {
+		cost.lFound = true;
+		auto sharedLibs = cls->GetSharedLibs();
+		if (sharedLibs != nullptr) {
+			std::istringstream libraryList(sharedLibs);
+			libraryList >> cost.lLibrary;
+		}
+	}
+	lClassCosts.emplace_back(std::move(cost));
+	return cls;
+}
+
+void loadCostAuditor::fReport(std::ostream& aStream, bool aFull) const {
+	std::vector<const classCost*> classRanking;
+	std::map<std::string, libraryCost> libraryCosts;
+	for (auto& cost : lClassCosts) {
+		classRanking.push_back(&cost);
+		auto& library = libraryCosts[cost.lLibrary.empty() ? "(unknown)" : cost.lLibrary];
+		library.lSeconds += cost.lSeconds;
+		library.lResidentKB += cost.lResidentKB;
+		library.lClasses++;
+		library.lLoadedLibraries += cost.lLoadedLibraries.size();
+		library.lAutoparsed += cost.lAutoparsed ? 1 : 0;
+	}
+	std::sort(classRanking.begin(), classRanking.end(), [](const classCost * aLeft, const classCost * aRight) {
+		return aLeft->lSeconds > aRight->lSeconds;
+	});
+	std::vector<libraryCost> libraryRanking;
+	for (auto& library : libraryCosts) {
+		libraryRanking.push_back(library.second);
+		libraryRanking.back().lLibrary = library.first;
+	}
+	std::sort(libraryRanking.begin(), libraryRanking.end(), [](const libraryCost & aLeft, const libraryCost & aRight) {
+		return aLeft.lSeconds > aRight.lSeconds;
+	});
+
+	Double_t totalSeconds = 0;
+	std::size_t totalAutoparsed = 0;
+	for (auto& cost : lClassCosts) {
+		totalSeconds += cost.lSeconds;
+		totalAutoparsed += cost.lAutoparsed ? 1 : 0;
+	}
+	aStream << TString::Format("Materialization of %zu classes took %.3f s, %zu of them needed autoparsing.",
+	                           lClassCosts.size(), totalSeconds, totalAutoparsed) << std::endl;
+
+	auto classEntries = aFull ? classRanking.size() : std::min(classRanking.size(), static_cast<std::size_t>(kReportEntries));
+	aStream << "Most expensive classes (wall time, RSS growth, libraries loaded):" << std::endl;
+	for (std::size_t i = 0; i < classEntries; ++i) {
+		auto& cost = *classRanking[i];
+		TString autoparsed = cost.lAutoparsed ? TString::Format(" [autoparsed %zu]", cost.lAutoparseEvents) : TString();
+		aStream << TString::Format("%4zu. %10.3f ms %10ld kB %4zu libs  %s%s%s",
+		                           i + 1, cost.lSeconds * 1e3, cost.lResidentKB, cost.lLoadedLibraries.size(),
+		                           cost.lClassName.c_str(), autoparsed.Data(),
+		                           cost.lFound ? "" : " [not found]") << std::endl;
+		for (auto& library : cost.lLoadedLibraries) {
+			aStream << "              loaded " << library << std::endl;
+		}
+	}
+
+	auto libraryEntries = aFull ? libraryRanking.size() : std::min(libraryRanking.size(), static_cast<std::size_t>(kReportEntries));
+	aStream << "Most expensive libraries (summed over their classes):" << std::endl;
+	for (std::size_t i = 0; i < libraryEntries; ++i) {
+		auto& library = libraryRanking[i];
+		aStream << TString::Format("%4zu. %10.3f ms %10ld kB %4zu libs %5zu classes %5zu autoparsed  %s",
+		                           i + 1, library.lSeconds * 1e3, library.lResidentKB, library.lLoadedLibraries,
+		                           library.lClasses, library.lAutoparsed, library.lLibrary.c_str()) << std::endl;
+	}
+}
@@ -0,0 +1,74 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "memoryUtils.h"
+
+#include <atomic>
+
+#include <malloc.h>
+
+namespace {
+	bool gAllocationHookInstalled = false;
+	std::atomic<bool> gCountingEnabled(false);
+	std::atomic<Long64_t> gNetBytes(0);
+	std::atomic<Long64_t> gNetBlocks(0);
+}
+
+std::size_t memoryUtils::getHeapInUse() {
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+	struct mallinfo2 info = mallinfo2();
+#else
+	// Older glibc: int-fields, which may overflow beyond 2 GB. Good enough for differences.
+	struct mallinfo info = mallinfo();
+#endif
+	return static_cast<std::size_t>(info.uordblks) + static_cast<std::size_t>(info.hblkhd);
+}
+
+bool memoryUtils::isAllocationHookInstalled() {
+	return gAllocationHookInstalled;
+}
+
+void memoryUtils::markAllocationHookInstalled() {
+	gAllocationHookInstalled = true;
+}
+
+void memoryUtils::setAllocationCounting(bool aEnable) {
+	if (aEnable) {
+		gNetBytes = 0;
+		gNetBlocks = 0;
+	}
+	gCountingEnabled = aEnable;
+}
+
+memoryUtils::allocationCounters memoryUtils::getAllocationCounters() {
+	return allocationCounters{gNetBytes.load(), gNetBlocks.load()};
+}
+
+void memoryUtils::countAllocation(void* aPtr) {
+	if (aPtr != nullptr && gCountingEnabled.load(std::memory_order_relaxed)) {
+		gNetBytes.fetch_add(malloc_usable_size(aPtr), std::memory_order_relaxed);
+		gNetBlocks.fetch_add(1, std::memory_order_relaxed);
+	}
+}
+
+void memoryUtils::countDeallocation(void* aPtr) {
+	if (aPtr != nullptr && gCountingEnabled.load(std::memory_order_relaxed)) {
+		gNetBytes.fetch_sub(malloc_usable_size(aPtr), std::memory_order_relaxed);
+		gNetBlocks.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
@@ -0,0 +1,108 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "reflectionSnapshot.h"
+
+#include <TClass.h>
+#include <TBaseClass.h>
+#include <TDataMember.h>
+#include <TDataType.h>
+#include <TList.h>
+#include <TObjArray.h>
+#include <TRealData.h>
+#include <TStreamerElement.h>
+#include <TVirtualStreamerInfo.h>
+
+#include <string.h>
+
+reflectionSnapshot::reflectionSnapshot(TClass* aClass) :
+	lClass{aClass},
+	lClassName{aClass->GetName()},
+	lDeclFileName{(aClass->GetDeclFileName() != nullptr) ? aClass->GetDeclFileName() : ""},
+	lSize{static_cast<UInt_t>(aClass->Size())},
+	lClassVersion{aClass->GetClassVersion()},
+	lCheckSum{aClass->GetCheckSum()},
+	lHasCustomStreamerMember{aClass->TestBit(TClass::kHasCustomStreamerMember)} {
+
+	aClass->BuildRealData();
+	auto realData = aClass->GetListOfRealData();
+	if (realData != nullptr) {
+		TIter nextRD(realData);
+		TRealData* rd = nullptr;
+		while ((rd = dynamic_cast<TRealData*>(nextRD())) != nullptr) {
+			auto dm = rd->GetDataMember();
+			if (dm == nullptr) {
+				continue;
+			}
+			auto dt = dm->GetDataType();
+			auto owner = dm->GetClass();
+			Int_t elements = 1;
+			for (Int_t dim = 0; dim < dm->GetArrayDim(); ++dim) {
+				elements *= dm->GetMaxIndex(dim);
+			}
+			member snapshotMember;
+			snapshotMember.lRealData     = rd;
+			snapshotMember.lName         = rd->GetName();
+			snapshotMember.lMemberName   = dm->GetName();
+			snapshotMember.lTypeName     = dm->GetTypeName();
+			snapshotMember.lOwner        = owner;
+			snapshotMember.lOwnerName    = (owner != nullptr) ? owner->GetName() : "";
+			snapshotMember.lOwnerVersion = (owner != nullptr) ? owner->GetClassVersion() : 0;
+			snapshotMember.lOffset       = rd->GetThisOffset();
+			snapshotMember.lUnitSize     = dm->GetUnitSize();
+			snapshotMember.lElements     = elements;
+			snapshotMember.lDataType     = (dt != nullptr) ? dt->GetType() : kNoDataType;
+			snapshotMember.lArrayIndex   = (dm->GetArrayIndex() != nullptr) ? dm->GetArrayIndex() : "";
+			snapshotMember.lTransient    = rd->TestBit(TRealData::kTransient);
+			snapshotMember.lIsObject     = rd->IsObject();
+			snapshotMember.lIsPointer    = dm->IsaPointer();
+			snapshotMember.lIsBasic      = dm->IsBasic();
+			snapshotMember.lIsPersistent = dm->IsPersistent();
+			snapshotMember.lIsNested     = strchr(rd->GetName(), '.') != nullptr;
+			snapshotMember.lHasRange     = strchr(dm->GetTitle(), '[') != nullptr;
+			lMembers.push_back(std::move(snapshotMember));
+		}
+	}
+
+	auto bases = aClass->GetListOfBases();
+	if (bases != nullptr) {
+		TIter nextBase(bases);
+		TBaseClass* base = nullptr;
+		while ((base = dynamic_cast<TBaseClass*>(nextBase())) != nullptr) {
+			auto baseCls = base->GetClassPointer();
+			lBases.push_back(baseClass{baseCls, base->GetName(), base->GetDelta(),
+			                           static_cast<Version_t>((baseCls != nullptr) ? baseCls->GetClassVersion() : 0)});
+		}
+	}
+
+	// Unversioned classes are never streamed member-wise, do not create streamer infos for them.
+	if (lClassVersion > 0) {
+		auto info = aClass->GetStreamerInfo();
+		auto elements = (info != nullptr) ? info->GetElements() : nullptr;
+		if (elements != nullptr) {
+			for (Int_t i = 0; i < elements->GetEntriesFast(); ++i) {
+				auto element = dynamic_cast<TStreamerElement*>(elements->UncheckedAt(i));
+				if (element == nullptr) {
+					continue;
+				}
+				lStreamerElements.push_back(streamerElement{element->GetName(), element->GetTypeName(), element->GetType(),
+				                            element->GetOffset(), element->GetSize(), element->GetArrayLength(), element->IsBase()});
+			}
+		}
+	}
+}
@@ -43,28 +43,195 @@
 #include "Options.h"
 
 #include "classObject.h"
+#include "classHierarchyIndex.h"
 #include "testInterface.h"
 #include "utilityFunctions.h"
 #include "errorHandling.h"
 #include "streamingUtils.h"
+#include "analyzerDaemon.h"
+#include "crashHandling.h"
+#include "loadCostAuditor.h"
+#include "snapshotFile.h"
+#include "runHistory.h"
 
 #include "testingInitHook.h"
 
+// Runs the reflection-only tests on the classes of a snapshot file, no rootmap is scanned and no library loaded.
+static int runFromSnapshotFile(const std::string& aPath,
+                               const std::vector<std::string>& aClassNamePatterns,
+                               const std::vector<std::string>& aClassNameAntiPatterns,
+                               bool aDataObjectsOnly,
+                               const std::vector<std::string>& aTestNamePatterns,
+                               const std::vector<std::string>& aTestNameAntiPatterns,
+                               bool debug) {
+	snapshotFile snapshots;
+	if (!snapshots.fOpen(aPath)) {
+		std::cerr << "Snapshot file '" << aPath << "' could not be read or has an unsupported format!" << std::endl;
+		return 1;
+	}
+
+	std::set<std::string> classNames;
+	for (std::size_t i = 0; i < snapshots.fGetClassCount(); ++i) {
+		classNames.insert(snapshots.fGetClassName(i));
+	}
+	utilityFunctions::filterSetByPatterns(classNames, aClassNamePatterns, aClassNameAntiPatterns, debug);
+
+	classTable allClassObjects(testInterface::fGetTestIdCount());
+	std::set<std::string> staleLibraries;
+	for (std::size_t i = 0; i < snapshots.fGetClassCount(); ++i) {
+		if (classNames.find(snapshots.fGetClassName(i)) == classNames.end()) {
+			continue;
+		}
+		auto flags = snapshots.fGetClassFlags(i);
+		if (aDataObjectsOnly && !(flags & classTable::kIsDataObject)) {
+			continue;
+		}
+		if (!snapshots.fIsUpToDate(i)) {
+			staleLibraries.insert(snapshots.fGetLibraryPath(i));
+			continue;
+		}
+		allClassObjects.fAddSnapshot(snapshots.fGetSnapshot(i), flags);
+	}
+	for (auto& library : staleLibraries) {
+		std::cerr << "Library '" << library << "' changed since the snapshot was written, its classes are skipped." << std::endl;
+	}
+	if (debug) {
+		std::cout << "Using " << allClassObjects.size() << " classes from snapshot file '" << aPath << "'." << std::endl;
+	}
+
+	testingInitHook::initTests();
+	std::vector<testInterface*> reflectionOnlyTests;
+	for (auto test : utilityFunctions::selectTestsByPatterns(aTestNamePatterns, aTestNameAntiPatterns, debug)) {
+		if (test->fIsReflectionOnly()) {
+			reflectionOnlyTests.push_back(test);
+		}
+	}
+	auto orderedRows = runHistory::fOrderRows(allClassObjects);
+	testInterface::fRunTests(allClassObjects, reflectionOnlyTests, &orderedRows, debug);
+	return 0;
+}
+
+// Common end of all runs.
+static int finishRun(const std::string& aWriteBaselinePath, const std::string& aHistoryPath) {
+	if (errorHandling::getSuppressedCount() > 0) {
+		std::cout << errorHandling::getSuppressedCount() << " known diagnostics suppressed by the baseline." << std::endl;
+	}
+	if (!errorHandling::writeBaseline()) {
+		std::cerr << "Baseline file '" << aWriteBaselinePath << "' could not be written!" << std::endl;
+		return 1;
+	}
+	if (!aHistoryPath.empty() && !runHistory::fWrite(aHistoryPath)) {
+		std::cerr << "History file '" << aHistoryPath << "' could not be written!" << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+// Reflection data is only built for data objects which could be constructed.
+// Building a snapshot runs dictionary code, so it is protected as in the test runs: a crashing class
+// gets no snapshot (and is hence left out of the snapshot file) instead of ending the run unrecorded.
+static void buildSnapshots(classTable& allClassObjects, std::size_t aConstructionDestructionId) {
+	static const std::string contextName = "writeSnapshot";
+	for (auto cls : allClassObjects) {
+		if (!cls.fIsDataObject() || !cls.fWasTestedSuccessfully(aConstructionDestructionId)) {
+			continue;
+		}
+		volatile bool crashed = false;
+		errorHandling::setContext(&contextName, &cls.fGetClassName());
+		crashHandling::fArm();
+		TRY {
+			cls.fGetSnapshot();
+		} CATCH ( excode ) {
+			(void) excode;
+			crashed = true;
+		}
+		ENDTRY;
+		if (crashHandling::fCrashCaptured()) {
+			crashHandling::fCollectCrash(contextName, cls.fGetClassName(), cls.fGetTClass()->GetDeclFileName());
+		}
+		if (crashed) {
+			errorHandling::throwError(cls.fGetTClass()->GetDeclFileName(), 0, errorHandling::kWarning,
+			                          "Building the reflection snapshot crashed, the class is left out of the snapshot file.");
+		}
+		errorHandling::setContext(nullptr, nullptr);
+	}
+	crashHandling::fReportCrashes();
+}
+
 int main(int argc, char** argv) {
 	OptionParser parser("Simple static analyzer for ROOT and ROOT-based projects");
 
 	OptionContainer<std::string> rootMapPatterns('r', "rootMapPattern", "Regexp to match rootmaps to test with, can be given multiple times. '.*' matches all, no patterns given => test ROOT only.");
 	OptionContainer<std::string> classNamePatterns('c', "classNamePattern", "Regexp to match class-names to test, can be given multiple times. '.*' (or no pattern given) tests all.");
 	OptionContainer<std::string> classNameAntiPatterns('C', "classNameAntiPattern", "Regexp to match class-names NOT to test, can be given multiple times. Applied after a class has matched the classNamePattern.");
+	OptionContainer<std::string> inheritsFrom('i', "inheritsFrom", "Consider only classes inheriting from (or being) the given class, can be given multiple times.");
+	OptionContainer<std::string> testNamePatterns('t', "testNamePattern", "Regexp to match names of tests to run, can be given multiple times. No pattern given => run all tests. Note tests depending on deselected tests will not run.");
+	OptionContainer<std::string> testNameAntiPatterns('T', "testNameAntiPattern", "Regexp to match names of tests NOT to run, can be given multiple times.");
 	Option<bool> dataObjectsOnly('D', "dataObjectsOnly", "Consider only TObject-inheriting classes with Class-version > 0 for all tests.", false);
 	Option<bool> debug('d', "debug", "Make a lot of debug-noise to debug this program itself.", false);
+	Option<bool> benchmark('b', "benchmark", "Also run the (slow) benchmarks of tests supporting them, e.g. IsA()-dispatch timing.", false);
+	Option<std::string> daemonSocket('S', "daemonSocket", "Instead of testing once, keep ROOT warm and serve test-requests on this unix domain socket.", "");
+	Option<unsigned int> benchmarkIterations('n', "benchmarkIterations", "Number of calls per timed loop in benchmarks.", 100000);
+	Option<unsigned int> fuzzRoundTrips('f', "fuzzRoundTrips", "Number of streaming round-trips with random member values per class.", 1000);
+	Option<unsigned int> threads('j', "threads", "Threads for reflection-only tests (ROOT >= 6.06), others always run serially.", 1);
+	Option<std::string> baseline('B', "baseline", "Baseline file of known diagnostics, only new findings are reported.", "");
+	Option<std::string> writeBaseline('W', "writeBaseline", "Write all diagnostics of this run as a fresh baseline to this file.", "");
+	OptionContainer<std::string> referenceFiles('R', "referenceFile", "ROOT file written by an older software version, its stored streamer infos are compared with the live classes. Can be given multiple times.");
+	Option<std::string> snapshot('s', "snapshot", "Run only the reflection-only tests on the classes of this snapshot file, without loading any library.", "");
+	Option<std::string> writeSnapshot('w', "writeSnapshot", "Write reflection snapshots of all data objects which survived construction to this file.", "");
+	Option<std::string> goldenCorpus('g', "goldenCorpus", "Compare the streamed default objects with this golden corpus, flags format changes without class-version bump.", "");
+	Option<std::string> writeGoldenCorpus('G', "writeGoldenCorpus", "Append the streamed default objects of this run to this golden corpus (created if missing).", "");
+	Option<std::string> history('H', "history", "File with durations and outcomes per class and test. Read to run previous failures and slow classes first, updated at the end.", "");
+	Option<bool> checkRootmaps('m', "checkRootmaps", "Report classes registered more than once (or for different libraries) in the rootmaps, and the extra libraries autoloading pulls in.", false);
+	Option<bool> auditLoadCost('A', "auditLoadCost", "Measure time, memory and libraries loaded when materializing each class and print a ranked report (complete with -d).", false);
 
 	// We need a TApplication-instance to allow for rootmap-checks - at least for ROOT 5.
 	gROOT->SetBatch(kTRUE);
 	TApplication app("app", nullptr, nullptr);
 
+	// Has to come after ROOT installed its signal handlers.
+	crashHandling::fInstall();
+
 	auto unusedOptions = parser.fParse(argc, argv);
 
+	testInterface::fGetSettings().lBenchmark = benchmark;
+	testInterface::fGetSettings().lIterations = benchmarkIterations;
+	testInterface::fGetSettings().lFuzzRoundTrips = fuzzRoundTrips;
+	testInterface::fGetSettings().lThreads = threads;
+	testInterface::fGetSettings().lReferenceFiles.assign(referenceFiles.begin(), referenceFiles.end());
+	testInterface::fGetSettings().lGoldenCorpus = goldenCorpus;
+	testInterface::fGetSettings().lWriteGoldenCorpus = writeGoldenCorpus;
+
+	const std::string& baselinePath = baseline;
+	if (!baselinePath.empty() && !errorHandling::loadBaseline(baselinePath.c_str())) {
+		std::cerr << "Baseline file '" << baselinePath << "' could not be read!" << std::endl;
+		exit(1);
+	}
+	const std::string& writeBaselinePath = writeBaseline;
+	if (!writeBaselinePath.empty()) {
+		errorHandling::recordBaseline(writeBaselinePath.c_str());
+	}
+
+	const std::string& historyPath = history;
+	if (!historyPath.empty() && !runHistory::fLoad(historyPath)) {
+		std::cerr << "History file '" << historyPath << "' could not be read!" << std::endl;
+		exit(1);
+	}
+
+	const std::string& snapshotPath = snapshot;
+	if (!snapshotPath.empty()) {
+		if (!inheritsFrom.empty()) {
+			std::cerr << "Selecting subclasses is not supported when running from a snapshot file!" << std::endl;
+			exit(1);
+		}
+		auto result = runFromSnapshotFile(snapshotPath, classNamePatterns, classNameAntiPatterns, dataObjectsOnly,
+		                                  testNamePatterns, testNameAntiPatterns, debug);
+		if (result != 0) {
+			return result;
+		}
+		return finishRun(writeBaselinePath, historyPath);
+	}
+
 	if (rootMapPatterns.empty()) {
 		/* Test ROOT only. */
 		TString rootLibDir(utilityFunctions::getRootLibDir());
@@ -72,7 +239,12 @@ int main(int argc, char** argv) {
 	}
 
 	// Get all rootmaps filtered by the patterns.
-	std::set<std::string> allClasses{utilityFunctions::getRootmapsByRegexps(rootMapPatterns, debug)};
+	auto rootmapRegistry = utilityFunctions::getRootmapsByRegexps(rootMapPatterns, debug);
+	if (checkRootmaps) {
+		auto findings = utilityFunctions::checkRootmapRegistrations(rootmapRegistry);
+		std::cout << findings << " classes are registered more than once in the rootmaps." << std::endl;
+	}
+	std::set<std::string> allClasses{utilityFunctions::getClassNames(rootmapRegistry)};
 
 	// Filter by classname-patterns.
 	utilityFunctions::filterSetByPatterns(allClasses, classNamePatterns, classNameAntiPatterns, debug);
@@ -88,25 +260,57 @@ int main(int argc, char** argv) {
 
 	// Silent TClass lookup, triggers autoloading / autoparsing.
 	std::set<TClass*> allTClasses;
-	std::vector<classObject> allClassObjects;
+	std::vector<TClass*> materializedClasses;
+	loadCostAuditor auditor;
 	for (auto& clsName : allClasses) {
-		auto cls = TClass::GetClass(clsName.c_str(), kTRUE);
-		if (cls != nullptr) {
-			allTClasses.insert(cls);
-			bool toBeTested = true;
-			if (dataObjectsOnly) {
-				if (!cls->InheritsFrom(TObject::Class()) || !(cls->GetClassVersion() > 0)) {
-					toBeTested = false;
-				}
-			}
-			if (toBeTested) {
-				allClassObjects.emplace_back(cls);
+		auto cls = auditLoadCost ? auditor.fGetClass(clsName) : TClass::GetClass(clsName.c_str(), kTRUE);
+		if (cls != nullptr && allTClasses.insert(cls).second) {
+			materializedClasses.push_back(cls);
+		}
+	}
+	if (auditLoadCost) {
+		auditor.fReport(std::cout, debug);
+	}
+
+	// Inheritance-queries below (and in the tests) are answered by the index from now on.
+	auto& hierarchy = classHierarchyIndex::fGetIndex();
+	hierarchy.fBuild(materializedClasses);
+
+	std::set<TClass*> inheritingClasses;
+	for (auto& baseName : inheritsFrom) {
+		auto baseClass = TClass::GetClass(baseName.c_str(), kTRUE);
+		if (baseClass == nullptr) {
+			std::cerr << "Class '" << baseName << "' given to select subclasses of is unknown!" << std::endl;
+			exit(1);
+		}
+		auto subclasses = hierarchy.fGetSubclasses(baseClass);
+		inheritingClasses.insert(subclasses.begin(), subclasses.end());
+	}
+
+	auto tobjectId = hierarchy.fGetId(TObject::Class());
+	classTable allClassObjects(testInterface::fGetTestIdCount());
+	for (auto cls : materializedClasses) {
+		bool toBeTested = true;
+		if (dataObjectsOnly) {
+			if (!hierarchy.fInheritsFrom(hierarchy.fGetId(cls), tobjectId) || !(cls->GetClassVersion() > 0)) {
+				toBeTested = false;
 			}
 		}
+		if (!inheritsFrom.empty() && inheritingClasses.find(cls) == inheritingClasses.end()) {
+			toBeTested = false;
+		}
+		if (toBeTested) {
+			allClassObjects.fAddClass(cls);
+		}
 	}
 
 	// BEGIN OF UGLY HACKS
-	for (auto& cls : allClassObjects) {
+	auto gedFrameId = hierarchy.fGetId("TGedFrame");
+	auto shapeId = hierarchy.fGetId("TShape");
+	auto constructionDestructionId = testInterface::fGetTestId("ConstructionDestruction");
+	auto streamingId = testInterface::fGetTestId("Streaming");
+	for (auto cls : allClassObjects) {
+		auto clsId = hierarchy.fGetId(cls.fGetTClass());
 		if (TString(cls.fGetClassName()).BeginsWith("TEve")
 		        || TString(cls.fGetClassName()).BeginsWith("TG")
 		        || TString(cls.fGetClassName()).BeginsWith("TMVA")
@@ -133,18 +337,18 @@ int main(int argc, char** argv) {
 		        || strcmp(cls.fGetClassName().c_str(), "TRotMatrix") == 0
 		        || strcmp(cls.fGetClassName().c_str(), "TSessionDescription") == 0
 		        || strcmp(cls.fGetClassName().c_str(), "TMinuit2TraceObject") == 0
-		        || cls.fGetTClass()->InheritsFrom("TGedFrame")
-		        || cls.fGetTClass()->InheritsFrom("TShape")
+		        || hierarchy.fInheritsFrom(clsId, gedFrameId)
+		        || hierarchy.fInheritsFrom(clsId, shapeId)
 		   ) {
 			if (!cls.fIsDataObject()) {
-				cls.fMarkTested("ConstructionDestruction", false);
+				cls.fMarkTested(constructionDestructionId, classObject::kSkipped);
 			}
 		}
 		if (TString(cls.fGetClassName()).BeginsWith("TEve")
 		    || TString(cls.fGetClassName()).BeginsWith("TPyth") /* FLOOD OF TEXT */
 		    || strcmp(cls.fGetClassName().c_str(), "TGWindow") == 0
-		    || cls.fGetTClass()->InheritsFrom("TShape")) {
-			cls.fMarkTested("ConstructionDestruction", false);
+		    || hierarchy.fInheritsFrom(clsId, shapeId)) {
+			cls.fMarkTested(constructionDestructionId, classObject::kSkipped);
 		}
 		if (strcmp(cls.fGetClassName().c_str(), "TBranchObject") == 0
 		    || strcmp(cls.fGetClassName().c_str(), "TCanvas") == 0
@@ -153,7 +357,7 @@ int main(int argc, char** argv) {
 		    || strcmp(cls.fGetClassName().c_str(), "TTreeRow") == 0
 		    || strcmp(cls.fGetClassName().c_str(), "TClonesArray") == 0
 		    || strcmp(cls.fGetClassName().c_str(), "TStreamerInfo") == 0) {
-			cls.fMarkTested("Streaming", false);
+			cls.fMarkTested(streamingId, classObject::kSkipped);
 		}
 	}
 	// END OF UGLY HACKS
@@ -172,17 +376,29 @@ int main(int argc, char** argv) {
 		exit(1);
 	}
 	
-	std::size_t executedTests = 0;
-	do {
-		executedTests = 0;
-		for (auto& test : allTests) {
-			auto testsRun = test.second->fRunTestOnClasses(allClassObjects, debug);
-			std::cout << test.first << ": " << testsRun << std::endl;
-			executedTests += testsRun;
-		}
-	} while (executedTests > 0);
+	auto selectedTests = utilityFunctions::selectTestsByPatterns(testNamePatterns, testNameAntiPatterns, debug);
 
-	return 0;
+	const std::string& daemonSocketPath = daemonSocket;
+	if (!daemonSocketPath.empty()) {
+		analyzerDaemon daemon(allClassObjects, daemonSocketPath, debug);
+		return daemon.fServe(argv);
+	}
+
+	// Without history, this is the alphabetical order.
+	auto orderedRows = runHistory::fOrderRows(allClassObjects);
+	testInterface::fRunTests(allClassObjects, selectedTests, &orderedRows, debug);
+	for (auto test : selectedTests) {
+		test->fFinalize();
+	}
+
+	const std::string& writeSnapshotPath = writeSnapshot;
+	if (!writeSnapshotPath.empty()) {
+		buildSnapshots(allClassObjects, constructionDestructionId);
+		auto written = snapshotFile::fWrite(writeSnapshotPath, allClassObjects);
+		std::cout << "Wrote snapshots of " << written << " classes to '" << writeSnapshotPath << "'." << std::endl;
+	}
+
+	return finishRun(writeBaselinePath, historyPath);
 
 }
 
@@ -0,0 +1,148 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "runHistory.h"
+
+#include <TSystem.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace {
+	struct historyEntry {
+		Long64_t lNs;
+		classObject::testStatus lStatus;
+	};
+
+	std::mutex gHistoryMutex;
+	bool gRecording = false;  //< Only once a history file was given, recording is not free.
+	// (class, test) => last result, ordered so the file stays stable and diffable.
+	std::map<std::pair<std::string, std::string>, historyEntry> gHistory;
+
+	bool isFailure(classObject::testStatus aStatus) {
+		return aStatus == classObject::kFailed || aStatus == classObject::kCrashed || aStatus == classObject::kTimeout;
+	}
+}
+
+bool runHistory::fLoad(const std::string& aPath) {
+	gRecording = true;
+	// Note AccessPathName() returns kTRUE if the file does NOT exist.
+	if (gSystem->AccessPathName(aPath.c_str())) {
+		// No history yet.
+		return true;
+	}
+	std::ifstream input(aPath);
+	if (!input) {
+		return false;
+	}
+	std::string line;
+	while (std::getline(input, line)) {
+		if (line.empty() || line[0] == '#') {
+			continue;
+		}
+		// status <tab> ns <tab> test <tab> class, the class name goes last as it may contain anything but tabs.
+		char* end = nullptr;
+		auto status = strtoul(line.c_str(), &end, 10);
+		if (end == line.c_str() || *end != '\t' || status > classObject::kTimeout) {
+			continue;
+		}
+		auto nsStart = end + 1;
+		auto ns = strtoll(nsStart, &end, 10);
+		if (end == nsStart || *end != '\t') {
+			continue;
+		}
+		auto testStart = end + 1 - line.c_str();
+		auto testEnd = line.find('\t', testStart);
+		if (testEnd == std::string::npos) {
+			continue;
+		}
+		gHistory[std::make_pair(line.substr(testEnd + 1), line.substr(testStart, testEnd - testStart))]
+		        = historyEntry{ns, static_cast<classObject::testStatus>(status)};
+	}
+	return true;
+}
+
+void runHistory::fRecord(const std::string& aTestName, const std::string& aClassName, Double_t aNs, classObject::testStatus aStatus) {
+	if (!gRecording) {
+		return;
+	}
+	std::lock_guard<std::mutex> lock(gHistoryMutex);
+	gHistory[std::make_pair(aClassName, aTestName)] = historyEntry{static_cast<Long64_t>(aNs), aStatus};
+}
+
+bool runHistory::fWrite(const std::string& aPath) {
+	std::lock_guard<std::mutex> lock(gHistoryMutex);
+	// Write to a temporary file first, an interrupted run must not lose the history.
+	std::string temporaryPath = aPath + ".tmp";
+	{
+		std::ofstream output(temporaryPath, std::ios::trunc);
+		output << "# rootStaticAnalyzer run history: status | ns | test | class." << std::endl;
+		for (auto& entry : gHistory) {
+			output << static_cast<unsigned int>(entry.second.lStatus) << "\t" << entry.second.lNs << "\t"
+			       << entry.first.second << "\t" << entry.first.first << std::endl;
+		}
+		if (!output) {
+			return false;
+		}
+	}
+	return rename(temporaryPath.c_str(), aPath.c_str()) == 0;
+}
+
+std::vector<std::size_t> runHistory::fOrderRows(classTable& aClasses) {
+	struct classWeight {
+		Double_t lNs;
+		bool lFailed;
+	};
+	std::unordered_map<std::string, classWeight> weights;
+	Double_t knownNs = 0.;
+	{
+		std::lock_guard<std::mutex> lock(gHistoryMutex);
+		for (auto& entry : gHistory) {
+			auto& weight = weights.emplace(entry.first.first, classWeight{0., false}).first->second;
+			weight.lNs += entry.second.lNs;
+			weight.lFailed = weight.lFailed || isFailure(entry.second.lStatus);
+			knownNs += entry.second.lNs;
+		}
+	}
+	Double_t meanNs = weights.empty() ? 0. : knownNs / weights.size();
+
+	std::vector<classWeight> rowWeights;
+	rowWeights.reserve(aClasses.size());
+	for (auto cls : aClasses) {
+		auto known = weights.find(cls.fGetClassName());
+		rowWeights.push_back((known != weights.end()) ? known->second : classWeight{meanNs, false});
+	}
+
+	std::vector<std::size_t> rows(aClasses.size());
+	for (std::size_t row = 0; row < rows.size(); ++row) {
+		rows[row] = row;
+	}
+	// Stable, so classes without history keep their (alphabetical) order.
+	std::stable_sort(rows.begin(), rows.end(), [&rowWeights](std::size_t aLhs, std::size_t aRhs) {
+		if (rowWeights[aLhs].lFailed != rowWeights[aRhs].lFailed) {
+			return rowWeights[aLhs].lFailed;
+		}
+		return rowWeights[aLhs].lNs > rowWeights[aRhs].lNs;
+	});
+	return rows;
+}
@@ -0,0 +1,404 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "snapshotFile.h"
+
+#include "classObject.h"
+#include "utilityFunctions.h"
+
+#include <TClass.h>
+#include <TSystem.h>
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <unordered_map>
+
+namespace {
+	const char kMagic[8] = {'R', 'S', 'A', 'S', 'N', 'A', 'P', '\0'};
+	const UInt_t kByteOrderMark = 0x01020304;
+	const UInt_t kNoLibrary = static_cast<UInt_t>(-1);
+
+	enum memberFlags : UShort_t {
+		kTransient  = 1 << 0,
+		kIsObject   = 1 << 1,
+		kIsPointer  = 1 << 2,
+		kIsBasic    = 1 << 3,
+		kPersistent = 1 << 4,
+		kIsNested   = 1 << 5,
+		kHasRange   = 1 << 6
+	};
+
+	// Deduplicating string pool, offset 0 is the empty string.
+	class stringPool {
+	  protected:
+		std::string lData = std::string(1, '\0');
+		std::unordered_map<std::string, UInt_t> lOffsets;
+	  public:
+		UInt_t fAdd(const std::string& aString) {
+			if (aString.empty()) {
+				return 0;
+			}
+			auto known = lOffsets.find(aString);
+			if (known != lOffsets.end()) {
+				return known->second;
+			}
+			UInt_t offset = lData.size();
+			lData.append(aString.c_str(), aString.size() + 1);
+			lOffsets.emplace(aString, offset);
+			return offset;
+		}
+		const std::string& fGetData() const {
+			return lData;
+		}
+	};
+
+	bool getLibraryIdentity(const std::string& aPath, Long64_t& aSize, Long64_t& aMTime) {
+		FileStat_t stat;
+		if (aPath.empty() || gSystem->GetPathInfo(aPath.c_str(), stat) != 0) {
+			return false;
+		}
+		aSize = stat.fSize;
+		aMTime = stat.fMtime;
+		return true;
+	}
+
+	template<typename Record> void writeRecords(std::ofstream& aOutput, const std::vector<Record>& aRecords) {
+		aOutput.write(reinterpret_cast<const char*>(aRecords.data()), aRecords.size() * sizeof(Record));
+	}
+}
+
+struct snapshotFile::fileHeader {
+	char lMagic[8];
+	UInt_t lFormatVersion;
+	UInt_t lByteOrder;
+	UInt_t lLibraryCount;
+	UInt_t lClassCount;
+	UInt_t lMemberCount;
+	UInt_t lBaseCount;
+	ULong64_t lStringPoolSize;
+};
+
+struct snapshotFile::libraryRecord {
+	UInt_t lPath;
+	UInt_t lPadding;
+	Long64_t lSize;
+	Long64_t lMTime;
+};
+
+struct snapshotFile::classRecord {
+	UInt_t lName;
+	UInt_t lDeclFileName;
+	UInt_t lLibrary;
+	UInt_t lSize;
+	UInt_t lCheckSum;
+	UInt_t lMembersBegin;
+	UInt_t lMembersCount;
+	UInt_t lBasesBegin;
+	UInt_t lBasesCount;
+	Short_t lVersion;
+	UChar_t lFlags;                    //< classTable::classFlags.
+	UChar_t lHasCustomStreamerMember;
+};
+
+struct snapshotFile::memberRecord {
+	Long64_t lOffset;
+	UInt_t lName;
+	UInt_t lMemberName;
+	UInt_t lTypeName;
+	UInt_t lOwnerName;
+	UInt_t lArrayIndex;
+	Int_t lUnitSize;
+	Int_t lElements;
+	Int_t lDataType;
+	Short_t lOwnerVersion;
+	UShort_t lFlags;                   //< memberFlags.
+	UInt_t lPadding;
+};
+
+struct snapshotFile::baseRecord {
+	UInt_t lName;
+	Int_t lOffset;
+	Short_t lVersion;
+	Short_t lPadding;
+	UInt_t lPadding2;
+};
+
+static_assert(sizeof(snapshotFile::fileHeader) % 8 == 0, "Records need to keep 8-byte alignment.");
+static_assert(sizeof(snapshotFile::libraryRecord) % 8 == 0, "Records need to keep 8-byte alignment.");
+static_assert(sizeof(snapshotFile::classRecord) % 8 == 0, "Records need to keep 8-byte alignment.");
+static_assert(sizeof(snapshotFile::memberRecord) % 8 == 0, "Records need to keep 8-byte alignment.");
+static_assert(sizeof(snapshotFile::baseRecord) % 8 == 0, "Records need to keep 8-byte alignment.");
+
+std::size_t snapshotFile::fWrite(const std::string& aPath, classTable& aClasses) {
+	stringPool strings;
+	std::vector<libraryRecord> libraries;
+	std::vector<classRecord> classes;
+	std::vector<memberRecord> members;
+	std::vector<baseRecord> bases;
+	std::map<std::string, UInt_t> librariesBySharedLibs; //< Looking up the path of a library is slow, do it once.
+
+	for (std::size_t row = 0; row < aClasses.size(); ++row) {
+		auto cls = aClasses[row];
+		if (!aClasses.fHasSnapshot(row) || cls.fIsFromSnapshotFile()) {
+			continue;
+		}
+		auto& snapshot = cls.fGetSnapshot();
+
+		UInt_t library = kNoLibrary;
+		auto sharedLibs = cls.fGetTClass()->GetSharedLibs();
+		if (sharedLibs != nullptr) {
+			auto known = librariesBySharedLibs.find(sharedLibs);
+			if (known == librariesBySharedLibs.end()) {
+				auto libraryPath = utilityFunctions::getProvidingLibraryPath(cls.fGetTClass());
+				libraryRecord record{strings.fAdd(libraryPath), 0, 0, 0};
+				UInt_t libraryIndex = kNoLibrary;
+				if (getLibraryIdentity(libraryPath, record.lSize, record.lMTime)) {
+					libraryIndex = libraries.size();
+					libraries.push_back(record);
+				}
+				known = librariesBySharedLibs.emplace(sharedLibs, libraryIndex).first;
+			}
+			library = known->second;
+		}
+		if (library == kNoLibrary) {
+			// Could never be checked for changes.
+			continue;
+		}
+
+		classRecord record;
+		memset(&record, 0, sizeof(record));
+		record.lName                    = strings.fAdd(snapshot.lClassName);
+		record.lDeclFileName            = strings.fAdd(snapshot.lDeclFileName);
+		record.lLibrary                 = library;
+		record.lSize                    = snapshot.lSize;
+		record.lCheckSum                = snapshot.lCheckSum;
+		record.lMembersBegin            = members.size();
+		record.lMembersCount            = snapshot.lMembers.size();
+		record.lBasesBegin              = bases.size();
+		record.lBasesCount              = snapshot.lBases.size();
+		record.lVersion                 = snapshot.lClassVersion;
+		record.lFlags                   = aClasses.fGetFlags(row);
+		record.lHasCustomStreamerMember = snapshot.lHasCustomStreamerMember;
+		classes.push_back(record);
+
+		for (auto& member : snapshot.lMembers) {
+			memberRecord memberRec;
+			memset(&memberRec, 0, sizeof(memberRec));
+			memberRec.lOffset       = member.lOffset;
+			memberRec.lName         = strings.fAdd(member.lName);
+			memberRec.lMemberName   = strings.fAdd(member.lMemberName);
+			memberRec.lTypeName     = strings.fAdd(member.lTypeName);
+			memberRec.lOwnerName    = strings.fAdd(member.lOwnerName);
+			memberRec.lArrayIndex   = strings.fAdd(member.lArrayIndex);
+			memberRec.lUnitSize     = member.lUnitSize;
+			memberRec.lElements     = member.lElements;
+			memberRec.lDataType     = member.lDataType;
+			memberRec.lOwnerVersion = member.lOwnerVersion;
+			memberRec.lFlags        = (member.lTransient ? kTransient : 0) | (member.lIsObject ? kIsObject : 0)
+			                          | (member.lIsPointer ? kIsPointer : 0) | (member.lIsBasic ? kIsBasic : 0)
+			                          | (member.lIsPersistent ? kPersistent : 0) | (member.lIsNested ? kIsNested : 0)
+			                          | (member.lHasRange ? kHasRange : 0);
+			members.push_back(memberRec);
+		}
+		for (auto& base : snapshot.lBases) {
+			bases.push_back(baseRecord{strings.fAdd(base.lName), base.lOffset, base.lVersion, 0, 0});
+		}
+	}
+
+	// Pad the pool, so the file size stays a multiple of 8 as well.
+	std::string pool = strings.fGetData();
+	pool.resize((pool.size() + 7) / 8 * 8, '\0');
+
+	fileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.lMagic, kMagic, sizeof(kMagic));
+	header.lFormatVersion  = kFormatVersion;
+	header.lByteOrder      = kByteOrderMark;
+	header.lLibraryCount   = libraries.size();
+	header.lClassCount     = classes.size();
+	header.lMemberCount    = members.size();
+	header.lBaseCount      = bases.size();
+	header.lStringPoolSize = pool.size();
+
+	// Write to a temporary file first, readers must never see a half-written snapshot.
+	std::string temporaryPath = aPath + ".tmp";
+	{
+		std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+		output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		writeRecords(output, libraries);
+		writeRecords(output, classes);
+		writeRecords(output, members);
+		writeRecords(output, bases);
+		output.write(pool.data(), pool.size());
+		if (!output) {
+			return 0;
+		}
+	}
+	if (rename(temporaryPath.c_str(), aPath.c_str()) != 0) {
+		return 0;
+	}
+	return classes.size();
+}
+
+bool snapshotFile::fOpen(const std::string& aPath) {
+	lHeader = nullptr;
+	if (!lFile.fOpen(aPath) || lFile.fGetSize() < sizeof(fileHeader)) {
+		return false;
+	}
+	auto data = lFile.fGetData();
+	auto header = reinterpret_cast<const fileHeader*>(data);
+	if (memcmp(header->lMagic, kMagic, sizeof(kMagic)) != 0
+	        || header->lFormatVersion != kFormatVersion
+	        || header->lByteOrder != kByteOrderMark) {
+		return false;
+	}
+	ULong64_t expectedSize = sizeof(fileHeader)
+	                         + static_cast<ULong64_t>(header->lLibraryCount) * sizeof(libraryRecord)
+	                         + static_cast<ULong64_t>(header->lClassCount) * sizeof(classRecord)
+	                         + static_cast<ULong64_t>(header->lMemberCount) * sizeof(memberRecord)
+	                         + static_cast<ULong64_t>(header->lBaseCount) * sizeof(baseRecord)
+	                         + header->lStringPoolSize;
+	if (expectedSize != lFile.fGetSize()) {
+		return false;
+	}
+	lHeader = header;
+	data += sizeof(fileHeader);
+	lLibraries = reinterpret_cast<const libraryRecord*>(data);
+	data += header->lLibraryCount * sizeof(libraryRecord);
+	lClasses = reinterpret_cast<const classRecord*>(data);
+	data += header->lClassCount * sizeof(classRecord);
+	lMembers = reinterpret_cast<const memberRecord*>(data);
+	data += header->lMemberCount * sizeof(memberRecord);
+	lBases = reinterpret_cast<const baseRecord*>(data);
+	data += header->lBaseCount * sizeof(baseRecord);
+	lStrings = data;
+	if (!fValidate()) {
+		lHeader = nullptr;
+		return false;
+	}
+
+	lLibraryUpToDate.assign(header->lLibraryCount, false);
+	for (UInt_t library = 0; library < header->lLibraryCount; ++library) {
+		Long64_t size = 0;
+		Long64_t mtime = 0;
+		if (getLibraryIdentity(fGetString(lLibraries[library].lPath), size, mtime)) {
+			lLibraryUpToDate[library] = (size == lLibraries[library].lSize && mtime == lLibraries[library].lMTime);
+		}
+	}
+	return true;
+}
+
+bool snapshotFile::fValidate() const {
+	auto poolSize = lHeader->lStringPoolSize;
+	if (poolSize == 0 || lStrings[poolSize - 1] != '\0') {
+		// Then every offset inside the pool is a terminated string.
+		return false;
+	}
+	for (UInt_t library = 0; library < lHeader->lLibraryCount; ++library) {
+		if (lLibraries[library].lPath >= poolSize) {
+			return false;
+		}
+	}
+	for (UInt_t cls = 0; cls < lHeader->lClassCount; ++cls) {
+		auto& record = lClasses[cls];
+		if (record.lName >= poolSize || record.lDeclFileName >= poolSize
+		        || record.lLibrary >= lHeader->lLibraryCount
+		        || static_cast<ULong64_t>(record.lMembersBegin) + record.lMembersCount > lHeader->lMemberCount
+		        || static_cast<ULong64_t>(record.lBasesBegin) + record.lBasesCount > lHeader->lBaseCount) {
+			return false;
+		}
+	}
+	for (UInt_t member = 0; member < lHeader->lMemberCount; ++member) {
+		auto& record = lMembers[member];
+		if (record.lName >= poolSize || record.lMemberName >= poolSize || record.lTypeName >= poolSize
+		        || record.lOwnerName >= poolSize || record.lArrayIndex >= poolSize) {
+			return false;
+		}
+	}
+	for (UInt_t base = 0; base < lHeader->lBaseCount; ++base) {
+		if (lBases[base].lName >= poolSize) {
+			return false;
+		}
+	}
+	return true;
+}
+
+std::size_t snapshotFile::fGetClassCount() const {
+	return (lHeader != nullptr) ? lHeader->lClassCount : 0;
+}
+
+const char* snapshotFile::fGetClassName(std::size_t aClass) const {
+	return fGetString(lClasses[aClass].lName);
+}
+
+const char* snapshotFile::fGetLibraryPath(std::size_t aClass) const {
+	return fGetString(lLibraries[lClasses[aClass].lLibrary].lPath);
+}
+
+bool snapshotFile::fIsUpToDate(std::size_t aClass) const {
+	return lLibraryUpToDate[lClasses[aClass].lLibrary];
+}
+
+UChar_t snapshotFile::fGetClassFlags(std::size_t aClass) const {
+	return lClasses[aClass].lFlags;
+}
+
+std::unique_ptr<const reflectionSnapshot> snapshotFile::fGetSnapshot(std::size_t aClass) const {
+	auto& record = lClasses[aClass];
+	std::unique_ptr<reflectionSnapshot> snapshot(new reflectionSnapshot());
+	snapshot->lClassName               = fGetString(record.lName);
+	snapshot->lDeclFileName            = fGetString(record.lDeclFileName);
+	snapshot->lSize                    = record.lSize;
+	snapshot->lClassVersion            = record.lVersion;
+	snapshot->lCheckSum                = record.lCheckSum;
+	snapshot->lHasCustomStreamerMember = record.lHasCustomStreamerMember;
+
+	snapshot->lMembers.reserve(record.lMembersCount);
+	for (UInt_t i = record.lMembersBegin; i < record.lMembersBegin + record.lMembersCount; ++i) {
+		auto& memberRec = lMembers[i];
+		reflectionSnapshot::member member;
+		member.lRealData     = nullptr;
+		member.lName         = fGetString(memberRec.lName);
+		member.lMemberName   = fGetString(memberRec.lMemberName);
+		member.lTypeName     = fGetString(memberRec.lTypeName);
+		member.lOwner        = nullptr;
+		member.lOwnerName    = fGetString(memberRec.lOwnerName);
+		member.lOwnerVersion = memberRec.lOwnerVersion;
+		member.lOffset       = memberRec.lOffset;
+		member.lUnitSize     = memberRec.lUnitSize;
+		member.lElements     = memberRec.lElements;
+		member.lDataType     = memberRec.lDataType;
+		member.lArrayIndex   = fGetString(memberRec.lArrayIndex);
+		member.lTransient    = memberRec.lFlags & kTransient;
+		member.lIsObject     = memberRec.lFlags & kIsObject;
+		member.lIsPointer    = memberRec.lFlags & kIsPointer;
+		member.lIsBasic      = memberRec.lFlags & kIsBasic;
+		member.lIsPersistent = memberRec.lFlags & kPersistent;
+		member.lIsNested     = memberRec.lFlags & kIsNested;
+		member.lHasRange     = memberRec.lFlags & kHasRange;
+		snapshot->lMembers.push_back(std::move(member));
+	}
+
+	snapshot->lBases.reserve(record.lBasesCount);
+	for (UInt_t i = record.lBasesBegin; i < record.lBasesBegin + record.lBasesCount; ++i) {
+		snapshot->lBases.push_back(reflectionSnapshot::baseClass{nullptr, fGetString(lBases[i].lName), lBases[i].lOffset, lBases[i].lVersion});
+	}
+	return std::unique_ptr<const reflectionSnapshot>(std::move(snapshot));
+}
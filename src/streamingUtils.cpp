@@ -19,16 +19,21 @@
 #include "streamingUtils.h"
 
 #include "errorHandling.h"
+#include "reflectionSnapshot.h"
 
 #include <TBufferFile.h>
+#include <TObject.h>
 #include <TClass.h>
 #include <TRealData.h>
 #include <TDataMember.h>
+#include <TDataType.h>
 #include <TList.h>
 
-TString streamingUtils::streamObjectToBufferAndChecksum(TObject* obj) {
-	static TBufferFile buf(TBuffer::kWrite, 10000);
+#include <algorithm>
+#include <set>
+#include <string.h>
 
+void streamingUtils::streamObjectToBuffer(TBufferFile& buf, TObject* obj) {
 	// NECESSARY: Reset the map of the buffer, we may be re-using it.
 	// Buffers store internally a map of all known object pointers to only write them once.
 	// For our check, we re-use the buffer and re-write to it from the start - thus, we need to reset the map.
@@ -42,10 +47,10 @@ TString streamingUtils::streamObjectToBufferAndChecksum(TObject* obj) {
 
 	// Stream it.
 	obj->Streamer(buf);
+}
 
-	// Start the check.
+TString streamingUtils::checksumBuffer(TBufferFile& buf) {
 	Int_t bufSize = buf.Length();
-	buf.SetBufferOffset(0);
 	char* bufPtr  = buf.Buffer();
 
 	TMD5 checkSum;
@@ -54,55 +59,135 @@ TString streamingUtils::streamObjectToBufferAndChecksum(TObject* obj) {
 	return checkSum.AsString();
 }
 
-std::map<TString, std::pair<TMD5, TRealData*>> streamingUtils::getRealDataDigests(TObject* obj) {
+TString streamingUtils::streamObjectToBufferAndChecksum(TObject* obj) {
+	static TBufferFile buf(TBuffer::kWrite, 10000);
+
+	streamObjectToBuffer(buf, obj);
+
+	// Start the check.
+	auto checkSum = checksumBuffer(buf);
+	buf.SetBufferOffset(0);
+	return checkSum;
+}
+
+std::map<TString, std::pair<TMD5, TRealData*>> streamingUtils::getRealDataDigests(TObject* obj, const reflectionSnapshot& snapshot) {
 	std::map<TString, std::pair<TMD5, TRealData*>> digests;
 
-	auto cls = obj->IsA();
-	auto realData = cls->GetListOfRealData();
-	if (realData != nullptr && realData->GetEntries() > 0) {
-		TString unstreamedData;
-		TIter nextRD(realData);
-		TRealData* rd = nullptr;
-		while ((rd = dynamic_cast<TRealData*>(nextRD())) != nullptr) {
-			if (rd->IsObject()) {
-				// Skip that.
-				continue;
-			}
-			if (rd->TestBit(TRealData::kTransient)) {
-				// Skip transient members.
-				continue;
-			}
-			auto dm = rd->GetDataMember();
-			auto dt = dm->GetDataType();
-			if (dt == nullptr) {
-				continue;
-			}
-			/*
-			std::cout << obj->IsA()->GetName() << " - "
-			          << dm->GetName() << " - "
-			          << dt->Size() << " @ " << rd->GetThisOffset() << std::endl;
-			*/
-			auto memberAddress = reinterpret_cast<UChar_t*>(obj) + rd->GetThisOffset();
-			if (digests.find(rd->GetName()) != digests.end()) {
-				errorHandling::throwError(cls->GetDeclFileName(), 0,
-				                          errorHandling::kWarning,
-				                          TString::Format("Class '%s' contains more than one realdata-member called '%s', that's a bad idea!", cls->GetName(), rd->GetName()));
-				continue;
-			}
-			auto& digest = digests[rd->GetName()];
-			//digest = new TMD5();
-			digest.first.Update(memberAddress, dm->GetUnitSize() / sizeof(UChar_t));
-			digest.first.Final();
-			digest.second = rd;
-			/*
-			if (obj->IsA() == TClass::GetClass("TRandom3")) {
-				rd->Dump();
-				dm->Dump();
-				dt->Dump();
-			}
-			*/
-			//rd->Dump();
+	auto cls = snapshot.fGetTClass();
+	for (auto& member : snapshot.fGetMembers()) {
+		if (member.lIsObject) {
+			// Skip that.
+			continue;
+		}
+		if (member.lTransient) {
+			// Skip transient members.
+			continue;
+		}
+		if (member.lDataType == reflectionSnapshot::kNoDataType) {
+			continue;
 		}
+		auto memberAddress = reinterpret_cast<UChar_t*>(obj) + member.lOffset;
+		if (digests.find(member.lName.c_str()) != digests.end()) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0,
+			                          errorHandling::kWarning,
+			                          TString::Format("Class '%s' contains more than one realdata-member called '%s', that's a bad idea!", cls->GetName(), member.lName.c_str()));
+			continue;
+		}
+		auto& digest = digests[member.lName.c_str()];
+		digest.first.Update(memberAddress, member.lUnitSize / sizeof(UChar_t));
+		digest.first.Final();
+		digest.second = member.lRealData;
 	}
 	return digests;
 }
+
+std::vector<streamingUtils::fuzzableMember> streamingUtils::getFuzzableMembers(const reflectionSnapshot& snapshot) {
+	std::vector<fuzzableMember> members;
+
+	// Members giving the size of variable arrays (//[fN]) must keep their value, otherwise we stream garbage.
+	std::set<std::string> arraySizeMembers;
+	for (auto& member : snapshot.fGetMembers()) {
+		if (!member.lArrayIndex.empty()) {
+			arraySizeMembers.insert(member.lArrayIndex);
+		}
+	}
+
+	for (auto& member : snapshot.fGetMembers()) {
+		if (member.lIsObject || member.lTransient) {
+			continue;
+		}
+		if (!member.lIsPersistent || member.lIsPointer || !member.lIsBasic) {
+			continue;
+		}
+		auto owner = member.lOwner;
+		// TObject's bits steer its own streaming, members of non-streamed bases are checked elsewhere
+		// and custom Streamers may interpret any member as size or flag.
+		if (owner == nullptr || owner == TObject::Class() || member.lOwnerVersion <= 0 || owner->TestBit(TClass::kHasCustomStreamerMember)) {
+			continue;
+		}
+		if (arraySizeMembers.find(member.lMemberName) != arraySizeMembers.end()) {
+			continue;
+		}
+		Int_t dataType = member.lDataType;
+		if (dataType == reflectionSnapshot::kNoDataType) {
+			continue;
+		}
+		if (dataType == kBits || dataType == kCounter || dataType == kCharStar || dataType == kOther_t || dataType == kVoid_t) {
+			continue;
+		}
+		if ((dataType == kDouble32_t || dataType == kFloat16_t) && member.lHasRange) {
+			// Range / precision given, values would not survive the round-trip.
+			continue;
+		}
+		members.push_back(fuzzableMember{member.lRealData, member.lOffset, member.lUnitSize, member.lElements, dataType});
+	}
+	return members;
+}
+
+void streamingUtils::randomizeMembers(void* obj, const std::vector<fuzzableMember>& members, std::mt19937_64& rng) {
+	std::uniform_real_distribution<Double_t> realDist(-1e6, 1e6);
+	std::uniform_int_distribution<Int_t> float16Dist(-2048, 2048);
+	for (auto& member : members) {
+		auto address = reinterpret_cast<UChar_t*>(obj) + member.lOffset;
+		for (Int_t element = 0; element < member.lElements; ++element) {
+			auto elementAddress = address + element * member.lUnitSize;
+			switch (member.lDataType) {
+				case kBool_t: {
+					Bool_t value = (rng() & 1);
+					memcpy(elementAddress, &value, sizeof(value));
+					break;
+				}
+				case kFloat_t: {
+					Float_t value = realDist(rng);
+					memcpy(elementAddress, &value, sizeof(value));
+					break;
+				}
+				case kDouble_t: {
+					Double_t value = realDist(rng);
+					memcpy(elementAddress, &value, sizeof(value));
+					break;
+				}
+				case kDouble32_t: {
+					// Streamed as float.
+					Double_t value = static_cast<Float_t>(realDist(rng));
+					memcpy(elementAddress, &value, sizeof(value));
+					break;
+				}
+				case kFloat16_t: {
+					// Streamed with truncated mantissa, small integers survive that.
+					Float_t value = float16Dist(rng);
+					memcpy(elementAddress, &value, sizeof(value));
+					break;
+				}
+				default: {
+					// Integer types: any bit pattern is fine.
+					for (Int_t byte = 0; byte < member.lUnitSize; byte += sizeof(ULong64_t)) {
+						ULong64_t value = rng();
+						memcpy(elementAddress + byte, &value, std::min<Int_t>(sizeof(value), member.lUnitSize - byte));
+					}
+					break;
+				}
+			}
+		}
+	}
+}
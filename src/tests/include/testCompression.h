@@ -0,0 +1,65 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testCompression_h__
+#define __testCompression_h__
+
+#include "testInterface.h"
+
+#include <string>
+#include <vector>
+
+// Streams many objects back-to-back (freshly default-constructed, and with random values if the class survived
+// the fuzzing test) and compresses the payload with the algorithms ROOT was built with at several levels.
+// Reports compression factor and throughput, and blames the members of poorly compressing default payloads.
+// Only runs in benchmark-mode.
+class testCompression : public testInterface {
+  protected:
+	struct payload {
+		std::vector<char> lBytes;
+		std::vector<Int_t> lObjectOffsets;  //< Start of each object, plus the end of the last one.
+	};
+
+	struct memberColumn {
+		std::string lName;
+		Int_t lRawBytes;
+		Int_t lZipBytes;
+	};
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto streamingId = fGetTestId("Streaming");
+		return fGetSettings().lBenchmark && aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingId);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	payload fBuildPayload(classObject& aClass, bool aRandomize);
+	TString fMeasureAlgorithms(const payload& aPayload);
+	// Empty if the streamed layout of the class' own members can not be derived from its streamer elements.
+	std::vector<memberColumn> fAttributeMembers(classObject& aClass, const payload& aPayload);
+
+	static const Int_t kObjects = 256;                   //< Objects per payload...
+	static const Int_t kMaxPayloadBytes = 4 * 1024 * 1024; //< ... unless they get larger than this (below ROOT's zip block limit).
+	static const std::size_t kTimingIterations = 5;
+	static constexpr Double_t kPoorFactor = 2.;          //< Default payloads compressing worse than this are flagged.
+
+  public:
+	testCompression() : testInterface("Compression") { };
+};
+
+#endif /* __testCompression_h__ */
@@ -0,0 +1,68 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testConcurrentStreaming_h__
+#define __testConcurrentStreaming_h__
+
+#include "testInterface.h"
+
+#include <RVersion.h>
+
+#include <vector>
+
+// Constructs, streams and reads back independent objects of a class from many threads at once (with ROOT's
+// thread-safety enabled) and compares the bytes with the single-threaded ones, to find static scratch buffers
+// and racy lazy initialization in streamers and constructors. Runs in a forked child, so crashes and hangs
+// under concurrency are caught and the analyzer itself stays single-threaded.
+class testConcurrentStreaming : public testInterface {
+  protected:
+	static const UInt_t kMaxSteps = 16;
+
+	// Written by the child to the pipe, one entry per thread count (1, 2, 4, ... N in benchmark-mode, else N only).
+	struct childReport {
+		UInt_t lSteps;
+		UInt_t lThreads[kMaxSteps];
+		Double_t lObjectsPerSecond[kMaxSteps];
+		UInt_t lWriteMismatches[kMaxSteps];     //< Objects streamed to bytes differing from the reference.
+		UInt_t lReadBackMismatches[kMaxSteps];  //< Objects read back and re-streamed to differing bytes.
+	};
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,6,0)
+		static const auto readBackId = fGetTestId("StreamingReadBack");
+		return aClass.fWasTestedSuccessfully(readBackId);
+#else
+		(void) aClass;
+		return false;
+#endif
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	// Runs in the child. Fills aReport, the reference bytes are those of the default object from zeroed memory.
+	static void fStress(classObject& aClass, const std::vector<char>& aReference, unsigned int aMaxThreads, childReport& aReport);
+
+	static const std::size_t kObjectsPerThread = 200;  //< Round-trips per thread and thread count.
+	static const unsigned int kTimeoutSeconds = 120;   //< Children running longer are considered deadlocked.
+	static constexpr Double_t kPoorScaling = 1.;       //< Throughput on N threads below this multiple of one thread is flagged.
+
+  public:
+	testConcurrentStreaming() : testInterface("ConcurrentStreaming") { };
+};
+
+#endif /* __testConcurrentStreaming_h__ */
@@ -0,0 +1,48 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testConstructionLeaks_h__
+#define __testConstructionLeaks_h__
+
+#include "testInterface.h"
+#include "memoryUtils.h"
+
+// Data objects are also streamed in each cycle, so they are only checked once the streaming test has run.
+class testConstructionLeaks : public testInterface {
+  protected:
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto constructionDestructionId = fGetTestId("ConstructionDestruction");
+		static const auto streamingId = fGetTestId("Streaming");
+		return memoryUtils::isAllocationHookInstalled()
+		       && aClass.fWasTestedSuccessfully(constructionDestructionId)
+		       && (!aClass.fIsDataObject() || aClass.fWasTested(streamingId));
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	// A class leaks if the net heap bytes and blocks grow in both measurement windows after the warm-up, i.e. also
+	// a leak in only every n-th cycle counts. Amortized growth of caches (e.g. a vector doubling) shows up in one
+	// window at most.
+	static const std::size_t kWarmupCycles = 8;   //< Cycles before counting, for one-time allocations (TClass / StreamerInfo caches).
+	static const std::size_t kCycles       = 200; //< Cycles per measurement window.
+
+  public:
+	testConstructionLeaks() : testInterface("ConstructionLeaks") { };
+};
+
+#endif /* __testConstructionLeaks_h__ */
@@ -0,0 +1,42 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testCustomStreamer_h__
+#define __testCustomStreamer_h__
+
+#include "testInterface.h"
+
+// Lists dataobjects with hand-written or old-style Streamer() (no '+' in the LinkDef) or an external
+// TClassStreamer, and checks whether the automatic streamer info based streaming writes the same bytes
+// for the default object. Those custom streamers could be dropped: the class could then be split and use
+// ROOT's optimized streaming. In benchmark-mode, both ways are timed.
+class testCustomStreamer : public testInterface {
+  protected:
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto streamingId = fGetTestId("Streaming");
+		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingId)
+		       && (aClass.fGetSnapshot().fHasCustomStreamerMember() || aClass.fGetTClass()->GetStreamer() != nullptr);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+  public:
+	testCustomStreamer() : testInterface("CustomStreamer") { };
+};
+
+#endif /* __testCustomStreamer_h__ */
@@ -24,13 +24,18 @@
 class testDataObjBases : public testInterface {
   protected:
 	virtual bool fCheckPrerequisites(classObject& aClass) {
-		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully("ConstructionDestruction");
+		static const auto constructionDestructionId = fGetTestId("ConstructionDestruction");
+		return aClass.fIsDataObject() && (aClass.fIsFromSnapshotFile() || aClass.fWasTestedSuccessfully(constructionDestructionId));
 	};
 
 	virtual bool fRunTest(classObject& aClass);
 
   public:
 	testDataObjBases() : testInterface("DataObjBases") { };
+
+	virtual bool fIsReflectionOnly() const {
+		return true;
+	}
 };
 
 #endif /* __testDataObjBases_h__ */
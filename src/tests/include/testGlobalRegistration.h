@@ -0,0 +1,67 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testGlobalRegistration_h__
+#define __testGlobalRegistration_h__
+
+#include "testInterface.h"
+
+class TCollection;
+
+// Finds default constructors with global side effects: registration in gROOT's lists of cleanups / specials or in the
+// current directory (histogram-style auto-add), and kMustCleanup / kCanDelete set on the new object. Deleting such
+// objects triggers RecursiveRemove / list searches over everything alive, i.e. destruction is O(live objects).
+// In benchmark-mode, this is measured with few and with many live instances.
+class testGlobalRegistration : public testInterface {
+  protected:
+	enum globalList {
+		kCleanups,
+		kSpecials,
+		kRootObjects,
+		kDirectoryObjects,
+		kGlobalLists
+	};
+
+	struct globalState {
+		Int_t lSizes[kGlobalLists];
+	};
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto constructionDestructionId = fGetTestId("ConstructionDestruction");
+		return aClass.fWasTestedSuccessfully(constructionDestructionId);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	static globalState fGetGlobalState();
+	static const char* fGetListName(globalList aList);
+	// Ns per destruction while aLiveInstances instances are alive, negative if they do not fit in memory.
+	static Double_t fMeasureDestruction(TClass* aClass, std::size_t aLiveInstances);
+
+	static const std::size_t kFewInstances  = 1000;
+	static const std::size_t kManyInstances = 100000;
+	static const std::size_t kTimedDestructions = 100;           //< Destructions timed out of the live instances.
+	static const Long64_t kMaxLiveBytes = 1024LL * 1024 * 1024;  //< Larger classes skip the scaling benchmark.
+	static constexpr Double_t kMaxTeardownSeconds = 120.;        //< Estimated teardown of many instances may not take longer.
+	static constexpr Double_t kPoorScaling = 10.;                //< Destruction getting this much slower with many instances is flagged.
+
+  public:
+	testGlobalRegistration() : testInterface("GlobalRegistration") { };
+};
+
+#endif /* __testGlobalRegistration_h__ */
@@ -0,0 +1,50 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testGoldenCorpus_h__
+#define __testGoldenCorpus_h__
+
+#include "testInterface.h"
+
+#include <vector>
+
+// Streams a default-constructed object of each dataobject and compares the bytes with a golden corpus of an
+// earlier run (-g), and / or appends them to a corpus (-G). Changed bytes without a class-version bump are flagged,
+// since old files would then be read with a wrong layout. Only runs if a corpus is given.
+class testGoldenCorpus : public testInterface {
+  protected:
+	bool lCorporaOpened = false;
+	std::vector<bool> lReferenceSeen;  //< Per entry of the reference, to report classes which were not tested.
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto streamingId = fGetTestId("Streaming");
+		return (!fGetSettings().lGoldenCorpus.empty() || !fGetSettings().lWriteGoldenCorpus.empty())
+		       && aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingId);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	void fOpenCorpora();
+
+  public:
+	testGoldenCorpus() : testInterface("GoldenCorpus") { };
+
+	virtual void fFinalize();
+};
+
+#endif /* __testGoldenCorpus_h__ */
@@ -21,14 +21,25 @@
 
 #include "testInterface.h"
 
+#include <Rtypes.h>
+
+class TObject;
+
 class testIsA : public testInterface {
   protected:
 	virtual bool fCheckPrerequisites(classObject& aClass) {
-		return aClass.fInheritsTObject() && aClass.fWasTestedSuccessfully("ConstructionDestruction");
+		static const auto constructionDestructionId = fGetTestId("ConstructionDestruction");
+		return aClass.fInheritsTObject() && aClass.fWasTestedSuccessfully(constructionDestructionId);
 	};
 
 	virtual bool fRunTest(classObject& aClass);
 
+	// Timing of IsA() and InheritsFrom() compared to the cached ClassDef path, only in benchmark-mode.
+	void fBenchmarkIsA(classObject& aClass, TObject* aObj);
+
+	static constexpr Double_t kSlowFactor   = 4.;  //< IsA() slower than this multiple of the reference is flagged...
+	static constexpr Double_t kSlowMarginNs = 20.; //< ... if it also costs this many ns more.
+
   public:
 	testIsA() : testInterface("IsA") { };
 };
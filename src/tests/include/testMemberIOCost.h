@@ -0,0 +1,61 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testMemberIOCost_h__
+#define __testMemberIOCost_h__
+
+#include "testInterface.h"
+
+#include <string>
+
+// Flags own members of dataobjects with known-expensive I/O: node-based STL collections, pointers which are
+// never null but lack '//->', pointers to basic types without '//[n]' and TClonesArrays of classes holding
+// TClonesArrays themselves. Each finding comes with the bytes and time the member costs when streaming
+// the default object, measured by streaming the member on its own.
+class testMemberIOCost : public testInterface {
+  protected:
+	struct streamingCost {
+		Int_t lBytes;
+		Double_t lNs;
+	};
+
+	struct finding {
+		std::string lMemberName;
+		TString lProblem;
+		errorHandling::errorType lType;
+		bool lMeasured;
+		streamingCost lCost;
+	};
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto streamingId = fGetTestId("Streaming");
+		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingId);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	// Bytes aWriter writes into a fresh buffer, and the time it takes.
+	template <typename Writer> static streamingCost fMeasureStreaming(Writer aWriter);
+
+	static const std::size_t kTimingIterations = 1000;
+
+  public:
+	testMemberIOCost() : testInterface("MemberIOCost") { };
+};
+
+#endif /* __testMemberIOCost_h__ */
@@ -0,0 +1,53 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testMoveSemantics_h__
+#define __testMoveSemantics_h__
+
+#include "testInterface.h"
+
+#include <RVersion.h>
+
+// The type traits are evaluated by cling, so this needs ROOT 6.
+class testMoveSemantics : public testInterface {
+  protected:
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,0,0)
+		return aClass.fIsDataObject() && aClass.fGetTClass()->GetClassInfo() != nullptr;
+#else
+		return false;
+#endif
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	// Bits of the trait mask evaluated by the interpreter.
+	enum traitBits : Long_t {
+		kCopyConstructible        = 1 << 0,
+		kMoveConstructible        = 1 << 1,
+		kNothrowMoveConstructible = 1 << 2,
+		kMoveAssignable           = 1 << 3,
+		kNothrowMoveAssignable    = 1 << 4,
+		kNothrowCopyConstructible = 1 << 5,
+	};
+
+  public:
+	testMoveSemantics() : testInterface("MoveSemantics") { };
+};
+
+#endif /* __testMoveSemantics_h__ */
@@ -0,0 +1,69 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testSchemaEvolution_h__
+#define __testSchemaEvolution_h__
+
+#include "testInterface.h"
+
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Compares the streamer infos stored in reference files (given with -R) with the live classes.
+// Data objects whose stored version or checksum differs take the conversion path on reading.
+class testSchemaEvolution : public testInterface {
+  protected:
+	struct storedInfo {
+		std::string lFile;
+		Int_t lVersion;
+		UInt_t lCheckSum;
+		std::vector<std::pair<std::string, std::string>> lElements; //< Name and type of each streamer element.
+	};
+
+	// Class name => streamer infos found in the reference files, read on first use.
+	static const std::map<std::string, std::vector<storedInfo>>& fGetReferenceInfos();
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto constructionDestructionId = fGetTestId("ConstructionDestruction");
+		static const auto streamingId = fGetTestId("Streaming");
+		if (fGetSettings().lReferenceFiles.empty() || !aClass.fIsDataObject()
+		        || !aClass.fWasTestedSuccessfully(constructionDestructionId)) {
+			return false;
+		}
+		// The conversion benchmark needs the outcome of the streaming test, wait for it.
+		if (fGetSettings().lBenchmark && !aClass.fWasTested(streamingId)) {
+			return false;
+		}
+		auto& referenceInfos = fGetReferenceInfos();
+		return referenceInfos.find(aClass.fGetClassName()) != referenceInfos.end();
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	// Reads a sample object from the reference file, with conversion, and a re-written copy of it without.
+	void fBenchmarkConversion(classObject& aClass, const storedInfo& aInfo);
+
+	static const std::size_t kBenchmarkReads = 100; //< Reads per timed loop, each includes file access and decompression.
+
+  public:
+	testSchemaEvolution() : testInterface("SchemaEvolution") { };
+};
+
+#endif /* __testSchemaEvolution_h__ */
@@ -24,7 +24,8 @@
 class testStreaming : public testInterface {
   protected:
 	virtual bool fCheckPrerequisites(classObject& aClass) {
-		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully("ConstructionDestruction");
+		static const auto constructionDestructionId = fGetTestId("ConstructionDestruction");
+		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(constructionDestructionId);
 	};
 
 	virtual bool fRunTest(classObject& aClass);
@@ -0,0 +1,42 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testStreamingReadBack_h__
+#define __testStreamingReadBack_h__
+
+#include "testInterface.h"
+
+class testStreamingReadBack : public testInterface {
+  protected:
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto streamingId = fGetTestId("Streaming");
+		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingId);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	static const std::size_t kLeakWarmupReads = 16;   //< Reads before the heap is measured (caches, lazy allocations).
+	static const std::size_t kLeakCheckReads  = 1000; //< Reads over which heap growth is measured.
+	static const std::size_t kLeakToleranceBytes = 4096;
+	static constexpr Double_t kSlowFactor = 3.;       //< Reading slower than this multiple of writing is flagged.
+
+  public:
+	testStreamingReadBack() : testInterface("StreamingReadBack") { };
+};
+
+#endif /* __testStreamingReadBack_h__ */
@@ -24,7 +24,8 @@
 class testStreamingUninitialized : public testInterface {
   protected:
 	virtual bool fCheckPrerequisites(classObject& aClass) {
-		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully("Streaming");
+		static const auto streamingId = fGetTestId("Streaming");
+		return aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingId);
 	};
 
 	virtual bool fRunTest(classObject& aClass);
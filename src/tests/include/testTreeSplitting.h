@@ -0,0 +1,55 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef __testTreeSplitting_h__
+#define __testTreeSplitting_h__
+
+#include "testInterface.h"
+
+// Writes objects into a TTree in a memory file, unsplit and fully split, and compares the layouts.
+// Objects of classes which survived the fuzzing test are filled with random values, others stay default-constructed.
+// Only runs in benchmark-mode.
+class testTreeSplitting : public testInterface {
+  protected:
+	struct layoutResult {
+		Int_t lTopSplitLevel;  //< Split level the top branch really got.
+		Int_t lBranches;       //< All branches, including sub-branches.
+		Long64_t lTotBytes;    //< Uncompressed.
+		Long64_t lZipBytes;    //< Compressed.
+		Double_t lWriteNs;     //< Per entry.
+		Double_t lReadNs;      //< Per entry.
+	};
+
+	virtual bool fCheckPrerequisites(classObject& aClass) {
+		static const auto streamingReadBackId = fGetTestId("StreamingReadBack");
+		return fGetSettings().lBenchmark && aClass.fIsDataObject() && aClass.fWasTestedSuccessfully(streamingReadBackId);
+	};
+
+	virtual bool fRunTest(classObject& aClass);
+
+	layoutResult fMeasureLayout(classObject& aClass, Int_t aSplitLevel, bool aRandomize);
+
+	static const Long64_t kEntries = 1000;          //< Objects written per layout.
+	static constexpr Double_t kSlowFactor = 2.;     //< Split reading slower than this multiple of unsplit reading is flagged...
+	static constexpr Double_t kLargerFactor = 1.5;  //< ... as is a split layout compressing to this multiple of the unsplit one.
+
+  public:
+	testTreeSplitting() : testInterface("TreeSplitting") { };
+};
+
+#endif /* __testTreeSplitting_h__ */
@@ -0,0 +1,303 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testCompression.h"
+
+#include "benchmarkUtils.h"
+#include "errorHandling.h"
+#include "streamingUtils.h"
+
+#include <RVersion.h>
+#include <RZip.h>
+#include <TBufferFile.h>
+#include <TClass.h>
+#include <TVirtualStreamerInfo.h>
+
+#include <algorithm>
+#include <functional>
+#include <random>
+
+static testCompression instance = testCompression();
+
+namespace {
+	struct algorithmSpec {
+		const char* lName;
+		int lAlgorithm;  //< Numbering is the same in all ROOT versions.
+	};
+
+	const algorithmSpec kAlgorithms[] = {
+		{"ZLIB", 1},
+		{"LZMA", 2},
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,10,0)
+		{"LZ4", 4},
+#endif
+#if ROOT_VERSION_CODE >= ROOT_VERSION(6,20,0)
+		{"ZSTD", 5},
+#endif
+	};
+	const int kLevels[] = {1, 5, 9};
+	const int kZipBlockLimit = 0xffffff;  //< R__zip compresses at most this much in one block.
+
+	// The type of the algorithm argument changed between ROOT versions (int, ROOT::ECompressionAlgorithm,
+	// ROOT::RCompressionSetting::EAlgorithm::EValues), so deduce it from the function itself.
+	template <typename Algorithm>
+	Int_t zipWith(void (*aZip)(int, int*, char*, int*, char*, int*, Algorithm), int aLevel, int aAlgorithm,
+	              const std::vector<char>& aSource, std::vector<char>& aTarget) {
+		int srcSize = aSource.size();
+		int tgtSize = aTarget.size();
+		int zipBytes = 0;
+		aZip(aLevel, &srcSize, const_cast<char*>(aSource.data()), &tgtSize, aTarget.data(), &zipBytes, static_cast<Algorithm>(aAlgorithm));
+		return zipBytes;
+	}
+
+	// Returns 0 if the algorithm is not available or the result would not be smaller than the source.
+	Int_t zip(int aLevel, int aAlgorithm, const std::vector<char>& aSource, std::vector<char>& aTarget) {
+		return zipWith(&R__zipMultipleAlgorithm, aLevel, aAlgorithm, aSource, aTarget);
+	}
+
+	Int_t unzip(const std::vector<char>& aZipped, Int_t aZipBytes, std::vector<char>& aTarget) {
+		int srcSize = aZipBytes;
+		int tgtSize = aTarget.size();
+		int unzipBytes = 0;
+		R__unzip(&srcSize, reinterpret_cast<unsigned char*>(const_cast<char*>(aZipped.data())), &tgtSize,
+		         reinterpret_cast<unsigned char*>(aTarget.data()), &unzipBytes);
+		return unzipBytes;
+	}
+
+	// Bytes a basic streamer element occupies in the buffer per array element, 0 if that is not fixed.
+	Int_t streamedUnitSize(Int_t aType) {
+		switch (aType) {
+			case TVirtualStreamerInfo::kBool:
+			case TVirtualStreamerInfo::kChar:
+			case TVirtualStreamerInfo::kUChar:
+			case TVirtualStreamerInfo::kLegacyChar:
+				return 1;
+			case TVirtualStreamerInfo::kShort:
+			case TVirtualStreamerInfo::kUShort:
+				return 2;
+			case TVirtualStreamerInfo::kInt:
+			case TVirtualStreamerInfo::kUInt:
+			case TVirtualStreamerInfo::kCounter:
+			case TVirtualStreamerInfo::kBits:
+			case TVirtualStreamerInfo::kFloat:
+			case TVirtualStreamerInfo::kDouble32:  // Only without range, checked by the caller.
+				return 4;
+			case TVirtualStreamerInfo::kLong:      // Always streamed as 64 bit.
+			case TVirtualStreamerInfo::kULong:
+			case TVirtualStreamerInfo::kLong64:
+			case TVirtualStreamerInfo::kULong64:
+			case TVirtualStreamerInfo::kDouble:
+				return 8;
+			default:
+				return 0;
+		}
+	}
+}
+
+testCompression::payload testCompression::fBuildPayload(classObject& aClass, bool aRandomize) {
+	auto cls = aClass.fGetTClass();
+	payload result;
+
+	static TBufferFile buf(TBuffer::kWrite, 64 * 1024);
+	buf.SetWriteMode();
+	buf.SetBufferOffset(0);
+
+	std::vector<streamingUtils::fuzzableMember> members;
+	TObject* randomObj = nullptr;
+	if (aRandomize) {
+		members = streamingUtils::getFuzzableMembers(aClass.fGetSnapshot());
+		randomObj = static_cast<TObject*>(cls->New(TClass::kRealNew));
+	}
+	auto seedBase = std::hash<std::string>()(aClass.fGetClassName());
+
+	for (Int_t i = 0; i < kObjects && buf.Length() < kMaxPayloadBytes; ++i) {
+		// Default payloads use a fresh object each time, so state set up per construction
+		// (counters, seeds, addresses, uninitialized members) shows up in the payload.
+		TObject* obj = randomObj;
+		if (aRandomize) {
+			std::mt19937_64 rng(seedBase + i);
+			streamingUtils::randomizeMembers(obj, members, rng);
+		} else {
+			obj = static_cast<TObject*>(cls->New(TClass::kRealNew));
+		}
+		result.lObjectOffsets.push_back(buf.Length());
+		buf.ResetMap();
+		buf.MapObject(obj);
+		obj->Streamer(buf);
+		if (!aRandomize) {
+			cls->Destructor(obj);
+		}
+	}
+	result.lObjectOffsets.push_back(buf.Length());
+	if (randomObj != nullptr) {
+		cls->Destructor(randomObj);
+	}
+
+	result.lBytes.assign(buf.Buffer(), buf.Buffer() + buf.Length());
+	buf.SetBufferOffset(0);
+	return result;
+}
+
+TString testCompression::fMeasureAlgorithms(const payload& aPayload) {
+	TString report;
+	Int_t rawBytes = aPayload.lBytes.size();
+	std::vector<char> zipped(rawBytes);
+	std::vector<char> unzipped(rawBytes);
+
+	for (auto& algorithm : kAlgorithms) {
+		for (auto level : kLevels) {
+			auto zipBytes = zip(level, algorithm.lAlgorithm, aPayload.lBytes, zipped);
+			if (zipBytes <= 0) {
+				// Algorithm not built in, or the payload does not get any smaller.
+				report += TString::Format(" %s-%d: incompressible;", algorithm.lName, level);
+				continue;
+			}
+			if (unzip(zipped, zipBytes, unzipped) != rawBytes || unzipped != aPayload.lBytes) {
+				report += TString::Format(" %s-%d: round-trip failed;", algorithm.lName, level);
+				continue;
+			}
+			auto zipNs = benchmarkUtils::nsPerCall(kTimingIterations, [&]() {
+				zip(level, algorithm.lAlgorithm, aPayload.lBytes, zipped);
+			}, 3);
+			auto unzipNs = benchmarkUtils::nsPerCall(kTimingIterations, [&]() {
+				unzip(zipped, zipBytes, unzipped);
+			}, 3);
+			// Bytes per ns are GB/s.
+			report += TString::Format(" %s-%d: factor %.2f, %.0f / %.0f MB/s;", algorithm.lName, level,
+			                          static_cast<Double_t>(rawBytes) / zipBytes, rawBytes * 1e3 / zipNs, rawBytes * 1e3 / unzipNs);
+		}
+	}
+	return report;
+}
+
+std::vector<testCompression::memberColumn> testCompression::fAttributeMembers(classObject& aClass, const payload& aPayload) {
+	std::vector<memberColumn> columns;
+	auto& snapshot = aClass.fGetSnapshot();
+	if (snapshot.fHasCustomStreamerMember()) {
+		return columns;
+	}
+
+	// The generated streamer writes the bases first and the own members last, in streamer element order.
+	// If all own members are basic with a fixed streamed size, they form the tail of each object.
+	std::vector<std::pair<std::string, Int_t>> ownMembers;
+	Int_t ownBytes = 0;
+	for (auto& element : snapshot.fGetStreamerElements()) {
+		if (element.lIsBase) {
+			continue;
+		}
+		auto type = element.lType;
+		Int_t length = 1;
+		if (type > TVirtualStreamerInfo::kOffsetL && type < TVirtualStreamerInfo::kOffsetP) {
+			type -= TVirtualStreamerInfo::kOffsetL;
+			length = element.lArrayLength;
+		}
+		auto unitSize = streamedUnitSize(type);
+		if (type == TVirtualStreamerInfo::kDouble32) {
+			for (auto& member : snapshot.fGetMembers()) {
+				if (member.lOwnerName == snapshot.fGetClassName() && member.lMemberName == element.lName && member.lHasRange) {
+					unitSize = 0;
+				}
+			}
+		}
+		if (unitSize == 0) {
+			return columns;
+		}
+		ownMembers.emplace_back(element.lName, unitSize * length);
+		ownBytes += unitSize * length;
+	}
+	if (ownMembers.empty()) {
+		return columns;
+	}
+
+	auto& offsets = aPayload.lObjectOffsets;
+	for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+		if (offsets[i + 1] - offsets[i] < ownBytes) {
+			return columns;
+		}
+	}
+
+	std::vector<char> column;
+	std::vector<char> zipped;
+	Int_t position = -ownBytes;  // Relative to the end of each object.
+	for (auto& ownMember : ownMembers) {
+		column.clear();
+		for (std::size_t i = 0; i + 1 < offsets.size(); ++i) {
+			auto start = aPayload.lBytes.data() + offsets[i + 1] + position;
+			column.insert(column.end(), start, start + ownMember.second);
+		}
+		position += ownMember.second;
+		zipped.resize(column.size());
+		auto zipBytes = zip(1, kAlgorithms[0].lAlgorithm, column, zipped);
+		Int_t rawBytes = column.size();
+		columns.push_back(memberColumn{ownMember.first, rawBytes, (zipBytes > 0) ? zipBytes : rawBytes});
+	}
+	return columns;
+}
+
+bool testCompression::fRunTest(classObject& aClass) {
+	static const auto streamingFuzzId = fGetTestId("StreamingFuzz");
+	auto cls = aClass.fGetTClass();
+
+	auto defaultPayload = fBuildPayload(aClass, false);
+	if (defaultPayload.lBytes.size() > static_cast<std::size_t>(kZipBlockLimit)) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("Compression of class '%s' not measured, a single object streams to %zu bytes.",
+		                                  cls->GetName(), defaultPayload.lBytes.size()));
+		return true;
+	}
+	Int_t objects = defaultPayload.lObjectOffsets.size() - 1;
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+	                          TString::Format("Compression of class '%s' (%d default-constructed objects, %zu bytes):%s",
+	                                  cls->GetName(), objects, defaultPayload.lBytes.size(), fMeasureAlgorithms(defaultPayload).Data()));
+
+	if (aClass.fWasTestedSuccessfully(streamingFuzzId)) {
+		auto randomPayload = fBuildPayload(aClass, true);
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("Compression of class '%s' (%d randomized objects, %zu bytes):%s",
+		                                  cls->GetName(), static_cast<Int_t>(randomPayload.lObjectOffsets.size() - 1),
+		                                  randomPayload.lBytes.size(), fMeasureAlgorithms(randomPayload).Data()));
+	}
+
+	// Identical default-constructed objects should compress extremely well, unless construction leaves
+	// something different in each object.
+	std::vector<char> zipped(defaultPayload.lBytes.size());
+	auto zipBytes = zip(1, kAlgorithms[0].lAlgorithm, defaultPayload.lBytes, zipped);
+	Double_t factor = (zipBytes > 0) ? static_cast<Double_t>(defaultPayload.lBytes.size()) / zipBytes : 1.;
+	if (objects < 2 || factor >= kPoorFactor) {
+		return true;
+	}
+
+	TString blamed;
+	auto columns = fAttributeMembers(aClass, defaultPayload);
+	std::sort(columns.begin(), columns.end(), [](const memberColumn& aLhs, const memberColumn& aRhs) {
+		return aLhs.lZipBytes > aRhs.lZipBytes;
+	});
+	for (auto& column : columns) {
+		if (static_cast<Double_t>(column.lRawBytes) / column.lZipBytes < kPoorFactor) {
+			blamed += TString::Format(" '%s' (%d of %d bytes left);", column.lName.c_str(), column.lZipBytes, column.lRawBytes);
+		}
+	}
+	if (blamed.Length() == 0) {
+		blamed = columns.empty() ? " members can not be told apart in the streamed layout." : " no single member stands out.";
+	}
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+	                          TString::Format("Default-constructed objects of dataobject '%s' only compress by a factor of %.2f, "
+	                                  "construction leaves different content in each object! Poorly compressing members:%s",
+	                                  cls->GetName(), factor, blamed.Data()));
+	return false;
+}
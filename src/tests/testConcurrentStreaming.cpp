@@ -0,0 +1,295 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testConcurrentStreaming.h"
+
+#include "errorHandling.h"
+#include "streamingUtils.h"
+
+#include <TBufferFile.h>
+#include <TClass.h>
+#include <TROOT.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static testConcurrentStreaming instance = testConcurrentStreaming();
+
+namespace {
+	bool hasBytes(TBufferFile& aBuf, const std::vector<char>& aBytes) {
+		return static_cast<std::size_t>(aBuf.Length()) == aBytes.size()
+		       && memcmp(aBuf.Buffer(), aBytes.data(), aBytes.size()) == 0;
+	}
+
+	bool writeAll(int aFd, const char* aData, std::size_t aSize) {
+		while (aSize > 0) {
+			auto written = write(aFd, aData, aSize);
+			if (written < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+				return false;
+			}
+			aData += written;
+			aSize -= written;
+		}
+		return true;
+	}
+
+	bool readAll(int aFd, char* aData, std::size_t aSize) {
+		while (aSize > 0) {
+			auto got = read(aFd, aData, aSize);
+			if (got < 0 && errno == EINTR) {
+				continue;
+			}
+			if (got <= 0) {
+				return false;
+			}
+			aData += got;
+			aSize -= got;
+		}
+		return true;
+	}
+}
+
+void testConcurrentStreaming::fStress(classObject& aClass, const std::vector<char>& aReference, unsigned int aMaxThreads, childReport& aReport) {
+	auto cls = aClass.fGetTClass();
+	auto uintCount = aClass.fGetSnapshot().fGetArenaUInts();
+
+	std::vector<unsigned int> threadCounts;
+	if (fGetSettings().lBenchmark) {
+		for (unsigned int threads = 1; threads < aMaxThreads && threadCounts.size() + 1 < kMaxSteps; threads *= 2) {
+			threadCounts.push_back(threads);
+		}
+	}
+	threadCounts.push_back(aMaxThreads);
+
+	aReport.lSteps = 0;
+	for (auto threadCount : threadCounts) {
+		std::atomic<unsigned int> ready(0);
+		std::atomic<UInt_t> writeMismatches(0);
+		std::atomic<UInt_t> readBackMismatches(0);
+
+		auto worker = [&]() {
+			std::vector<UInt_t> writeArena(uintCount);
+			std::vector<UInt_t> readArena(uintCount);
+			TBufferFile buf(TBuffer::kWrite, 10000);
+			TBufferFile reBuf(TBuffer::kWrite, 10000);
+			// Start all threads together, lazy initialization is what we are after.
+			ready++;
+			while (ready < threadCount) {
+				std::this_thread::yield();
+			}
+			for (std::size_t i = 0; i < kObjectsPerThread; ++i) {
+				std::fill(writeArena.begin(), writeArena.end(), 0);
+				std::fill(readArena.begin(), readArena.end(), 0);
+				TObject* obj     = static_cast<TObject*>(cls->New(writeArena.data(), TClass::kRealNew));
+				TObject* readObj = static_cast<TObject*>(cls->New(readArena.data(), TClass::kRealNew));
+
+				buf.SetWriteMode();
+				streamingUtils::streamObjectToBuffer(buf, obj);
+				if (!hasBytes(buf, aReference)) {
+					writeMismatches++;
+				}
+
+				buf.SetReadMode();
+				buf.SetBufferOffset(0);
+				buf.ResetMap();
+				buf.MapObject(readObj);
+				readObj->Streamer(buf);
+				reBuf.SetWriteMode();
+				streamingUtils::streamObjectToBuffer(reBuf, readObj);
+				if (!hasBytes(reBuf, aReference)) {
+					readBackMismatches++;
+				}
+
+				cls->Destructor(readObj, kTRUE);
+				cls->Destructor(obj, kTRUE);
+			}
+		};
+
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (unsigned int t = 1; t < threadCount; ++t) {
+			threads.emplace_back(worker);
+		}
+		worker();
+		for (auto& thread : threads) {
+			thread.join();
+		}
+		auto stop = std::chrono::steady_clock::now();
+
+		auto step = aReport.lSteps++;
+		aReport.lThreads[step] = threadCount;
+		aReport.lObjectsPerSecond[step] = threadCount * kObjectsPerThread / std::chrono::duration<Double_t>(stop - start).count();
+		aReport.lWriteMismatches[step] = writeMismatches;
+		aReport.lReadBackMismatches[step] = readBackMismatches;
+	}
+}
+
+bool testConcurrentStreaming::fRunTest(classObject& aClass) {
+#if ROOT_VERSION_CODE < ROOT_VERSION(6,6,0)
+	// No ROOT::EnableThreadSafety(), never selected by fCheckPrerequisites().
+	(void) aClass;
+	return true;
+#else
+	auto cls = aClass.fGetTClass();
+
+	// Single-threaded reference, from zeroed memory as in the threads.
+	std::vector<char> reference;
+	{
+		std::vector<UInt_t> arena(aClass.fGetSnapshot().fGetArenaUInts());
+		TObject* obj = static_cast<TObject*>(cls->New(arena.data(), TClass::kRealNew));
+		TBufferFile buf(TBuffer::kWrite, 10000);
+		streamingUtils::streamObjectToBuffer(buf, obj);
+		reference.assign(buf.Buffer(), buf.Buffer() + buf.Length());
+		cls->Destructor(obj, kTRUE);
+	}
+
+	unsigned int maxThreads = fGetSettings().lThreads;
+	if (maxThreads < 2) {
+		maxThreads = std::max(std::thread::hardware_concurrency(), 2u);
+	}
+	maxThreads = std::min(maxThreads, 1u << (kMaxSteps - 1));
+
+	int fds[2];
+	if (pipe(fds) != 0) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("ConcurrentStreaming of class '%s' skipped, no pipe to the child: %s",
+		                                  cls->GetName(), strerror(errno)));
+		return false;
+	}
+	// Nothing may be left in our buffers, the child would write it again.
+	std::cout.flush();
+	std::cerr.flush();
+	auto pid = fork();
+	if (pid < 0) {
+		close(fds[0]);
+		close(fds[1]);
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("ConcurrentStreaming of class '%s' skipped, could not fork: %s",
+		                                  cls->GetName(), strerror(errno)));
+		return false;
+	}
+	if (pid == 0) {
+		close(fds[0]);
+		// Die on crashes right away: ROOT's (or our) handlers do not work on the worker threads.
+		for (auto sig : {SIGSEGV, SIGBUS, SIGILL, SIGFPE, SIGABRT}) {
+			signal(sig, SIG_DFL);
+		}
+		ROOT::EnableThreadSafety();
+		childReport report;
+		memset(&report, 0, sizeof(report));
+		fStress(aClass, reference, maxThreads, report);
+		// No exit(), neither ROOT's nor the analyzer's teardown belongs to the child.
+		_exit(writeAll(fds[1], reinterpret_cast<const char*>(&report), sizeof(report)) ? 0 : 1);
+	}
+	close(fds[1]);
+
+	int status = 0;
+	bool timedOut = false;
+	auto start = std::chrono::steady_clock::now();
+	for (;;) {
+		auto result = waitpid(pid, &status, WNOHANG);
+		if (result == pid || (result < 0 && errno != EINTR)) {
+			break;
+		}
+		if (std::chrono::steady_clock::now() - start > std::chrono::seconds(static_cast<int>(kTimeoutSeconds))) {
+			kill(pid, SIGKILL);
+			waitpid(pid, &status, 0);
+			timedOut = true;
+			break;
+		}
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	childReport report;
+	bool complete = !timedOut && WIFEXITED(status) && WEXITSTATUS(status) == 0
+	                && readAll(fds[0], reinterpret_cast<char*>(&report), sizeof(report));
+	close(fds[0]);
+
+	if (timedOut) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+		                          TString::Format("Dataobject '%s' did not finish concurrent streaming on up to %u threads within %u s (deadlock?)!",
+		                                  cls->GetName(), maxThreads, kTimeoutSeconds));
+		fMarkTimedOut();
+		return false;
+	}
+	if (WIFSIGNALED(status)) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+		                          TString::Format("Dataobject '%s' crashed (%s) when constructed and streamed on up to %u threads concurrently!",
+		                                  cls->GetName(), strsignal(WTERMSIG(status)), maxThreads));
+		return false;
+	}
+	if (!complete) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+		                          TString::Format("Concurrent streaming of dataobject '%s' ended without a result (exit status %d)!",
+		                                  cls->GetName(), WIFEXITED(status) ? WEXITSTATUS(status) : -1));
+		return false;
+	}
+
+	bool concurrencySafe = true;
+	for (UInt_t step = 0; step < report.lSteps; ++step) {
+		auto objects = report.lThreads[step] * kObjectsPerThread;
+		if (report.lWriteMismatches[step] > 0) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+			                          TString::Format("Dataobject '%s' streams different bytes when streamed on %u threads concurrently (%u of %lu objects)!",
+			                                  cls->GetName(), report.lThreads[step], report.lWriteMismatches[step],
+			                                  static_cast<unsigned long>(objects)));
+			concurrencySafe = false;
+		}
+		if (report.lReadBackMismatches[step] > 0) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+			                          TString::Format("Dataobject '%s' reads back different content when read on %u threads concurrently (%u of %lu objects)!",
+			                                  cls->GetName(), report.lThreads[step], report.lReadBackMismatches[step],
+			                                  static_cast<unsigned long>(objects)));
+			concurrencySafe = false;
+		}
+		if (!concurrencySafe) {
+			// Larger thread counts will not tell more.
+			break;
+		}
+	}
+
+	if (concurrencySafe && fGetSettings().lBenchmark && report.lSteps > 1) {
+		TString scaling;
+		auto singleThreaded = report.lObjectsPerSecond[0];
+		for (UInt_t step = 0; step < report.lSteps; ++step) {
+			scaling += TString::Format("%s%u: %.0f/s (%.2fx)", step > 0 ? ", " : "", report.lThreads[step],
+			                           report.lObjectsPerSecond[step], report.lObjectsPerSecond[step] / singleThreaded);
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("ConcurrentStreaming of class '%s', round-trips per second on N threads: %s.",
+		                                  cls->GetName(), scaling.Data()));
+		auto speedup = report.lObjectsPerSecond[report.lSteps - 1] / singleThreaded;
+		if (speedup < kPoorScaling) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+			                          TString::Format("Dataobject '%s' streams slower on %u threads than on one (%.2fx), a shared lock or cache line is contended!",
+			                                  cls->GetName(), report.lThreads[report.lSteps - 1], speedup));
+		}
+	}
+	return concurrencySafe;
+#endif
+}
@@ -48,7 +48,7 @@ bool testConstructionDestruction::fRunTest(classObject& aClass) {
 
 	if (!constructionDestructionWorked) {
 		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
-		                          TString::Format("Construction/Destruction of class '%s' failed, manual check of backtrace above is needed!", cls->GetName()));
+		                          TString::Format("Construction/Destruction of class '%s' failed, check the backtrace reported for it!", cls->GetName()));
 	}
 
 	return constructionDestructionWorked;
@@ -0,0 +1,75 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testConstructionLeaks.h"
+
+#include "errorHandling.h"
+#include "streamingUtils.h"
+
+#include <TClass.h>
+
+static testConstructionLeaks instance = testConstructionLeaks();
+
+bool testConstructionLeaks::fRunTest(classObject& aClass) {
+	static const auto streamingId = fGetTestId("Streaming");
+	auto cls = aClass.fGetTClass();
+	bool stream = aClass.fWasTestedSuccessfully(streamingId);
+
+	auto cycle = [&]() {
+		auto obj = cls->New(TClass::kRealNew);
+		if (stream) {
+			streamingUtils::streamObjectToBufferAndChecksum(static_cast<TObject*>(obj));
+		}
+		cls->Destructor(obj);
+	};
+
+	for (std::size_t i = 0; i < kWarmupCycles; ++i) {
+		cycle();
+	}
+
+	// Two windows: amortized growth of caches (e.g. a vector doubling) shows up in one of them at most,
+	// a real leak in both.
+	memoryUtils::allocationCounters windows[2];
+	for (auto& window : windows) {
+		memoryUtils::setAllocationCounting(true);
+		for (std::size_t i = 0; i < kCycles; ++i) {
+			cycle();
+		}
+		memoryUtils::setAllocationCounting(false);
+		window = memoryUtils::getAllocationCounters();
+	}
+
+	bool leaks = true;
+	for (auto& window : windows) {
+		if (window.lBytes <= 0 || window.lBlocks <= 0) {
+			leaks = false;
+		}
+	}
+	Double_t bytesPerCycle  = static_cast<Double_t>(windows[0].lBytes + windows[1].lBytes) / (2 * kCycles);
+	Double_t blocksPerCycle = static_cast<Double_t>(windows[0].lBlocks + windows[1].lBlocks) / (2 * kCycles);
+	if (leaks) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+		                          TString::Format("Class '%s' leaks %.1f bytes in %.2f blocks per construction%s/destruction!",
+		                                  cls->GetName(), bytesPerCycle, blocksPerCycle, stream ? "/streaming" : ""));
+	} else if (fGetSettings().lBenchmark) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("ConstructionLeaks of class '%s': net %.1f bytes in %.2f blocks per construction%s/destruction.",
+		                                  cls->GetName(), bytesPerCycle, blocksPerCycle, stream ? "/streaming" : ""));
+	}
+	return !leaks;
+}
@@ -0,0 +1,135 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testCustomStreamer.h"
+
+#include "benchmarkUtils.h"
+#include "errorHandling.h"
+
+#include <TBufferFile.h>
+#include <TClass.h>
+
+#include <cstring>
+#include <vector>
+
+static testCustomStreamer instance = testCustomStreamer();
+
+bool testCustomStreamer::fRunTest(classObject& aClass) {
+	auto cls = aClass.fGetTClass();
+
+	TString reasons;
+	if (aClass.fGetSnapshot().fHasCustomStreamerMember()) {
+		reasons += " hand-written or old-style Streamer();";
+	}
+	if (cls->GetStreamer() != nullptr) {
+		reasons += " external TClassStreamer;";
+	}
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+	                          TString::Format("Dataobject '%s' uses custom streaming:%s", cls->GetName(), reasons.Data()));
+
+	// Zeroed storage like in the streaming test, both ways stream the very same object.
+	auto uintCount = aClass.fGetSnapshot().fGetArenaUInts();
+	std::vector<UInt_t> storageArenaVector(uintCount);
+	std::vector<UInt_t> readArenaVector(uintCount);
+	TObject* obj     = static_cast<TObject*>(cls->New(storageArenaVector.data(), TClass::kRealNew));
+	TObject* readObj = static_cast<TObject*>(cls->New(readArenaVector.data(), TClass::kRealNew));
+
+	static TBufferFile customBuf(TBuffer::kWrite, 10000);
+	static TBufferFile automaticBuf(TBuffer::kWrite, 10000);
+	// TClass::Streamer() dispatches on the streamer type, so an external TClassStreamer takes precedence over obj->Streamer().
+	auto writeCustom = [&]() {
+		customBuf.SetWriteMode();
+		customBuf.ResetMap();
+		customBuf.SetBufferOffset(0);
+		customBuf.MapObject(obj);
+		cls->Streamer(obj, customBuf);
+	};
+	auto writeAutomatic = [&]() {
+		automaticBuf.SetWriteMode();
+		automaticBuf.ResetMap();
+		automaticBuf.SetBufferOffset(0);
+		automaticBuf.MapObject(obj);
+		automaticBuf.WriteClassBuffer(cls, obj);
+	};
+	auto readCustom = [&]() {
+		customBuf.SetReadMode();
+		customBuf.SetBufferOffset(0);
+		customBuf.ResetMap();
+		customBuf.MapObject(readObj);
+		cls->Streamer(readObj, customBuf);
+	};
+	auto readAutomatic = [&]() {
+		automaticBuf.SetReadMode();
+		automaticBuf.SetBufferOffset(0);
+		automaticBuf.ResetMap();
+		automaticBuf.MapObject(readObj);
+		automaticBuf.ReadClassBuffer(cls, readObj);
+	};
+
+	writeCustom();
+	writeAutomatic();
+	Int_t customLength = customBuf.Length();
+	Int_t automaticLength = automaticBuf.Length();
+	bool equivalent = (customLength == automaticLength && memcmp(customBuf.Buffer(), automaticBuf.Buffer(), customLength) == 0);
+
+	if (equivalent) {
+		TString timing;
+		if (fGetSettings().lBenchmark) {
+			auto iterations = fGetSettings().lIterations;
+			auto customWriteNs    = benchmarkUtils::nsPerCall(iterations, writeCustom);
+			auto automaticWriteNs = benchmarkUtils::nsPerCall(iterations, writeAutomatic);
+			auto customReadNs     = benchmarkUtils::nsPerCall(iterations, readCustom);
+			auto automaticReadNs  = benchmarkUtils::nsPerCall(iterations, readAutomatic);
+			timing = TString::Format(" Custom: write %.1f ns, read %.1f ns; automatic: write %.1f ns, read %.1f ns.",
+			                         customWriteNs, customReadNs, automaticWriteNs, automaticReadNs);
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("Custom streaming of dataobject '%s' writes the same %d bytes as the automatic streaming, "
+		                                  "it could be dropped (add '+' in the LinkDef) to allow splitting!%s",
+		                                  cls->GetName(), customLength, timing.Data()));
+	} else {
+		Int_t firstDifference = 0;
+		while (firstDifference < customLength && firstDifference < automaticLength
+		        && customBuf.Buffer()[firstDifference] == automaticBuf.Buffer()[firstDifference]) {
+			++firstDifference;
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("Custom streaming of dataobject '%s' writes %d bytes, automatic streaming %d bytes, first difference at byte %d: "
+		                                  "dropping it needs schema evolution rules.",
+		                                  cls->GetName(), customLength, automaticLength, firstDifference));
+		if (fGetSettings().lBenchmark) {
+			// Each way reads back its own bytes.
+			auto iterations = fGetSettings().lIterations;
+			auto customWriteNs    = benchmarkUtils::nsPerCall(iterations, writeCustom);
+			auto automaticWriteNs = benchmarkUtils::nsPerCall(iterations, writeAutomatic);
+			auto customReadNs     = benchmarkUtils::nsPerCall(iterations, readCustom);
+			auto automaticReadNs  = benchmarkUtils::nsPerCall(iterations, readAutomatic);
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+			                          TString::Format("CustomStreamer of class '%s': custom write %.1f ns, read %.1f ns; automatic write %.1f ns, read %.1f ns per object.",
+			                                  cls->GetName(), customWriteNs, customReadNs, automaticWriteNs, automaticReadNs));
+		}
+	}
+
+	customBuf.SetWriteMode();
+	customBuf.SetBufferOffset(0);
+	automaticBuf.SetWriteMode();
+	automaticBuf.SetBufferOffset(0);
+	cls->Destructor(readObj, kTRUE);
+	cls->Destructor(obj, kTRUE);
+	return !equivalent;
+}
@@ -19,59 +19,51 @@
 #include "testDataObjBases.h"
 #include "errorHandling.h"
 
-#include <TRealData.h>
-#include <TBaseClass.h>
-#include <TList.h>
-#include <TDataMember.h>
+#include <map>
+#include <string>
+#include <vector>
 
 static testDataObjBases instance = testDataObjBases();
 
 bool testDataObjBases::fRunTest(classObject& aClass) {
-	auto cls = aClass.fGetTClass();
-	cls->BuildRealData();
+	// Only reads the snapshot, so this also works for classes read from a snapshot file without any library loaded.
+	auto& snapshot = aClass.fGetSnapshot();
 	bool hasUnstreamedMembers = false;
-	auto realData = cls->GetListOfRealData();
-	if (realData != nullptr && realData->GetEntries() > 0) {
-		std::map<std::pair<std::string, Int_t>, std::vector<std::string>> unstreamedClassMembers;
-		TIter nextRD(realData);
-		TRealData* rd = nullptr;
-		while ((rd = dynamic_cast<TRealData*>(nextRD())) != nullptr) {
-			if (rd->TestBit(TRealData::kTransient)) {
-				// Skip transient members.
-				continue;
-			}
-			if (strchr(rd->GetName(), '.') != nullptr) {
-				// That's a member of one of our members.
-				// Don't descend, since only transientness of OUR member is interesting here.
-				continue;
-			}
-			auto dm = rd->GetDataMember();
-			auto dmClass = dm->GetClass();
-			if (dmClass->GetClassVersion() <= 0) {
-				// Ok, then this non-transient member will not be streamed - due to class-version zero!
-				unstreamedClassMembers[std::make_pair(dmClass->GetName(), dmClass->GetClassVersion())].push_back(rd->GetName());
-			}
+	std::map<std::pair<std::string, Int_t>, std::vector<std::string>> unstreamedClassMembers;
+	for (auto& member : snapshot.fGetMembers()) {
+		if (member.lTransient) {
+			// Skip transient members.
+			continue;
 		}
-		if (!unstreamedClassMembers.empty()) {
-			hasUnstreamedMembers = true;
-			TString unstreamedMembers;
-			for (auto& unstreamed : unstreamedClassMembers) {
-				if (unstreamedMembers.Length() > 0) {
-					unstreamedMembers += ", ";
-				}
-				TString memberList;
-				for (auto& memberName : unstreamed.second) {
-					if (memberList.Length() > 0) {
-						memberList += ", ";
-					}
-					memberList += memberName;
+		if (member.lIsNested) {
+			// That's a member of one of our members.
+			// Don't descend, since only transientness of OUR member is interesting here.
+			continue;
+		}
+		if (!member.lOwnerName.empty() && member.lOwnerVersion <= 0) {
+			// Ok, then this non-transient member will not be streamed - due to class-version zero!
+			unstreamedClassMembers[std::make_pair(member.lOwnerName, member.lOwnerVersion)].push_back(member.lName);
+		}
+	}
+	if (!unstreamedClassMembers.empty()) {
+		hasUnstreamedMembers = true;
+		TString unstreamedMembers;
+		for (auto& unstreamed : unstreamedClassMembers) {
+			if (unstreamedMembers.Length() > 0) {
+				unstreamedMembers += ", ";
+			}
+			TString memberList;
+			for (auto& memberName : unstreamed.second) {
+				if (memberList.Length() > 0) {
+					memberList += ", ";
 				}
-				unstreamedMembers += TString::Format("members '%s' from class '%s' (class-version %d)", memberList.Data(), unstreamed.first.first.c_str(), unstreamed.first.second);
+				memberList += memberName;
 			}
-			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
-			                          TString::Format("Data object class '%s' will not stream the following indirect members: %s!",
-			                                  cls->GetName(), unstreamedMembers.Data()));
+			unstreamedMembers += TString::Format("members '%s' from class '%s' (class-version %d)", memberList.Data(), unstreamed.first.first.c_str(), unstreamed.first.second);
 		}
+		errorHandling::throwError(snapshot.fGetDeclFileName(), 0, errorHandling::kError,
+		                          TString::Format("Data object class '%s' will not stream the following indirect members: %s!",
+		                                  snapshot.fGetClassName().c_str(), unstreamedMembers.Data()));
 	}
 	return !hasUnstreamedMembers;
 }
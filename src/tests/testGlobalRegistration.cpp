@@ -0,0 +1,163 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testGlobalRegistration.h"
+
+#include "errorHandling.h"
+
+#include <TClass.h>
+#include <TDirectory.h>
+#include <TList.h>
+#include <TROOT.h>
+
+#include <chrono>
+#include <vector>
+
+static testGlobalRegistration instance = testGlobalRegistration();
+
+testGlobalRegistration::globalState testGlobalRegistration::fGetGlobalState() {
+	globalState state;
+	TCollection* lists[kGlobalLists] = {
+		gROOT->GetListOfCleanups(),
+		gROOT->GetListOfSpecials(),
+		gROOT->GetList(),
+		// Usually gROOT itself, do not count it twice.
+		(gDirectory != nullptr && gDirectory != gROOT) ? gDirectory->GetList() : nullptr
+	};
+	for (Int_t i = 0; i < kGlobalLists; ++i) {
+		state.lSizes[i] = (lists[i] != nullptr) ? lists[i]->GetSize() : 0;
+	}
+	return state;
+}
+
+const char* testGlobalRegistration::fGetListName(globalList aList) {
+	switch (aList) {
+		case kCleanups:
+			return "gROOT's list of cleanups";
+		case kSpecials:
+			return "gROOT's list of specials";
+		case kRootObjects:
+			return "gROOT's list of objects";
+		case kDirectoryObjects:
+			return "gDirectory";
+		default:
+			return "unknown list";
+	}
+}
+
+Double_t testGlobalRegistration::fMeasureDestruction(TClass* aClass, std::size_t aLiveInstances) {
+	if (static_cast<Long64_t>(aClass->Size()) * static_cast<Long64_t>(aLiveInstances) > kMaxLiveBytes) {
+		return -1.;
+	}
+	std::vector<void*> instances(aLiveInstances);
+	for (auto& obj : instances) {
+		obj = aClass->New(TClass::kRealNew);
+	}
+	// Destroy instances spread over the creation order, list positions decide the cost of linear searches.
+	std::size_t stride = aLiveInstances / kTimedDestructions;
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t i = 0; i < kTimedDestructions; ++i) {
+		aClass->Destructor(instances[i * stride]);
+		instances[i * stride] = nullptr;
+	}
+	auto stop = std::chrono::steady_clock::now();
+	// The rest in creation order: searches of lists appended to find them at the front, which keeps this linear.
+	for (auto obj : instances) {
+		if (obj != nullptr) {
+			aClass->Destructor(obj);
+		}
+	}
+	return std::chrono::duration<Double_t, std::nano>(stop - start).count() / kTimedDestructions;
+}
+
+bool testGlobalRegistration::fRunTest(classObject& aClass) {
+	auto cls = aClass.fGetTClass();
+
+	auto before = fGetGlobalState();
+	auto obj = cls->New(TClass::kRealNew);
+	auto constructed = fGetGlobalState();
+	bool mustCleanup = false;
+	bool canDelete = false;
+	if (aClass.fInheritsTObject()) {
+		mustCleanup = static_cast<TObject*>(obj)->TestBit(TObject::kMustCleanup);
+		canDelete = static_cast<TObject*>(obj)->TestBit(TObject::kCanDelete);
+	}
+	cls->Destructor(obj);
+	auto destructed = fGetGlobalState();
+
+	bool sideEffects = false;
+	for (Int_t i = 0; i < kGlobalLists; ++i) {
+		auto listName = fGetListName(static_cast<globalList>(i));
+		auto added = constructed.lSizes[i] - before.lSizes[i];
+		auto left = destructed.lSizes[i] - before.lSizes[i];
+		if (added != 0) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+			                          TString::Format("Default constructor of class '%s' changes the size of %s by %+d, its destruction becomes O(live objects)!",
+			                                  cls->GetName(), listName, added));
+			sideEffects = true;
+		}
+		if (left != 0) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+			                          TString::Format("Construction and destruction of class '%s' leave the size of %s changed by %+d!",
+			                                  cls->GetName(), listName, left));
+			sideEffects = true;
+		}
+	}
+	if (mustCleanup) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("Default constructor of class '%s' sets kMustCleanup, each deletion calls RecursiveRemove on all cleanups!",
+		                                  cls->GetName()));
+		sideEffects = true;
+	}
+	if (canDelete) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("Default constructor of class '%s' sets kCanDelete, containers holding it will delete it.",
+		                                  cls->GetName()));
+	}
+
+	// Without global side effects, destruction does not depend on other instances.
+	if (sideEffects && fGetSettings().lBenchmark) {
+		auto fewNs = fMeasureDestruction(cls, kFewInstances);
+		// Assuming linear growth, tearing down the many instances costs about this much.
+		Double_t teardownSeconds = fewNs * 1e-9 * (kManyInstances / kFewInstances) * kManyInstances;
+		auto manyNs = (fewNs >= 0. && teardownSeconds < kMaxTeardownSeconds) ? fMeasureDestruction(cls, kManyInstances) : -1.;
+		if (fewNs < 0.) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+			                          TString::Format("GlobalRegistration of class '%s': too large to keep %lu instances alive.",
+			                                  cls->GetName(), static_cast<unsigned long>(kFewInstances)));
+		} else if (manyNs < 0.) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+			                          TString::Format("GlobalRegistration of class '%s': destruction takes %.1f ns with %lu live instances, "
+			                                  "%lu live instances were skipped (too large or estimated teardown %.0f s)!",
+			                                  cls->GetName(), fewNs, static_cast<unsigned long>(kFewInstances),
+			                                  static_cast<unsigned long>(kManyInstances), teardownSeconds));
+		} else {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+			                          TString::Format("GlobalRegistration of class '%s': destruction takes %.1f ns with %lu and %.1f ns with %lu live instances.",
+			                                  cls->GetName(), fewNs, static_cast<unsigned long>(kFewInstances),
+			                                  manyNs, static_cast<unsigned long>(kManyInstances)));
+			if (manyNs > kPoorScaling * fewNs) {
+				errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+				                          TString::Format("Destruction of class '%s' gets %.1f times slower with %lu instead of %lu live instances!",
+				                                  cls->GetName(), manyNs / fewNs, static_cast<unsigned long>(kManyInstances),
+				                                  static_cast<unsigned long>(kFewInstances)));
+			}
+		}
+	}
+	return !sideEffects;
+}
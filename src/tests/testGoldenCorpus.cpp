@@ -0,0 +1,131 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testGoldenCorpus.h"
+
+#include "errorHandling.h"
+#include "goldenCorpus.h"
+#include "streamingUtils.h"
+
+#include <TBufferFile.h>
+#include <TClass.h>
+
+#include <cstring>
+#include <iostream>
+
+static testGoldenCorpus instance = testGoldenCorpus();
+
+namespace {
+	// Mappings are not copyable, so they can not live in the (copy-initialized) test instance.
+	goldenCorpus gReferenceCorpus;
+	goldenCorpus gOutputCorpus;
+}
+
+void testGoldenCorpus::fOpenCorpora() {
+	lCorporaOpened = true;
+	auto& settings = fGetSettings();
+	if (!settings.lGoldenCorpus.empty()) {
+		if (gReferenceCorpus.fOpen(settings.lGoldenCorpus)) {
+			lReferenceSeen.assign(gReferenceCorpus.fGetEntryCount(), false);
+		} else {
+			std::cerr << "Golden corpus '" << settings.lGoldenCorpus << "' could not be read or has an unsupported format!" << std::endl;
+		}
+	}
+	if (!settings.lWriteGoldenCorpus.empty()) {
+		// Missing is fine, it is created on commit.
+		gOutputCorpus.fOpen(settings.lWriteGoldenCorpus);
+	}
+}
+
+bool testGoldenCorpus::fRunTest(classObject& aClass) {
+	if (!lCorporaOpened) {
+		fOpenCorpora();
+	}
+	auto cls = aClass.fGetTClass();
+
+	// Zeroed storage like in the streaming test, so uninitialized members can not make the bytes differ between runs.
+	std::vector<UInt_t> storageArenaVector(aClass.fGetSnapshot().fGetArenaUInts());
+	TObject* obj = static_cast<TObject*>(cls->New(storageArenaVector.data(), TClass::kRealNew));
+	static TBufferFile buf(TBuffer::kWrite, 10000);
+	streamingUtils::streamObjectToBuffer(buf, obj);
+	cls->Destructor(obj, kTRUE);
+
+	auto version = cls->GetClassVersion();
+	const char* bytes = buf.Buffer();
+	UInt_t length = buf.Length();
+	bool unchanged = true;
+
+	if (gReferenceCorpus.fIsOpen()) {
+		auto index = gReferenceCorpus.fFind(aClass.fGetClassName());
+		if (index == gReferenceCorpus.fGetEntryCount()) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+			                          TString::Format("Dataobject '%s' is not in the golden corpus yet.", cls->GetName()));
+		} else {
+			lReferenceSeen[index] = true;
+			auto golden = gReferenceCorpus.fGetEntry(index);
+			// Checksums first, the bytes only need to be touched for changed classes.
+			if (golden.lLength != length || golden.lChecksum != goldenCorpus::fChecksum(bytes, length)
+			        || memcmp(golden.lBytes, bytes, length) != 0) {
+				UInt_t firstDifference = 0;
+				while (firstDifference < length && firstDifference < golden.lLength && golden.lBytes[firstDifference] == bytes[firstDifference]) {
+					++firstDifference;
+				}
+				if (golden.lVersion == version) {
+					errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+					                          TString::Format("Streamed default object of dataobject '%s' changed without class-version bump (still %d): "
+					                                  "%u bytes instead of %u, first difference at byte %u!",
+					                                  cls->GetName(), version, length, golden.lLength, firstDifference));
+					unchanged = false;
+				} else {
+					errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+					                          TString::Format("Streamed default object of dataobject '%s' changed with class-version %d -> %d: "
+					                                  "%u bytes instead of %u, first difference at byte %u.",
+					                                  cls->GetName(), golden.lVersion, version, length, golden.lLength, firstDifference));
+				}
+			}
+		}
+	}
+
+	if (!fGetSettings().lWriteGoldenCorpus.empty()) {
+		gOutputCorpus.fStage(aClass.fGetClassName(), version, bytes, length);
+	}
+	buf.SetBufferOffset(0);
+	return unchanged;
+}
+
+void testGoldenCorpus::fFinalize() {
+	auto& settings = fGetSettings();
+	if (gReferenceCorpus.fIsOpen()) {
+		std::size_t notSeen = 0;
+		for (bool seen : lReferenceSeen) {
+			notSeen += seen ? 0 : 1;
+		}
+		if (notSeen > 0) {
+			std::cout << notSeen << " classes of golden corpus '" << settings.lGoldenCorpus << "' were not tested in this run." << std::endl;
+		}
+	}
+	if (lCorporaOpened && !settings.lWriteGoldenCorpus.empty()) {
+		auto written = gOutputCorpus.fCommit(settings.lWriteGoldenCorpus);
+		if (written < 0) {
+			std::cerr << "Golden corpus '" << settings.lWriteGoldenCorpus << "' could not be written (or is not a golden corpus)!" << std::endl;
+		} else {
+			std::cout << "Appended " << written << " new or changed streamed objects to golden corpus '" << settings.lWriteGoldenCorpus
+			          << "', which now holds " << gOutputCorpus.fGetEntryCount() << " classes." << std::endl;
+		}
+	}
+}
@@ -18,6 +18,7 @@
 
 #include "testIsA.h"
 #include "errorHandling.h"
+#include "benchmarkUtils.h"
 
 #include <TClass.h>
 
@@ -26,8 +27,7 @@ static testIsA instance = testIsA();
 bool testIsA::fRunTest(classObject& aClass) {
 	auto cls = aClass.fGetTClass();
 
-	UInt_t classSize = cls->Size();
-	UInt_t uintCount = classSize / sizeof(UInt_t) + 1;
+	auto uintCount = aClass.fGetSnapshot().fGetArenaUInts();
 	std::vector<UInt_t> storageArenaVector(uintCount);
 	auto storageArena = storageArenaVector.data();
 
@@ -38,6 +38,57 @@ bool testIsA::fRunTest(classObject& aClass) {
 		                          TString::Format("IsA() of TObject-inheriting class '%s' return nullptr, this should not be!", cls->GetName()));
 		IsAworked = false;
 	}
+	if (IsAworked && fGetSettings().lBenchmark) {
+		fBenchmarkIsA(aClass, obj);
+	}
 	cls->Destructor(obj, kTRUE);
 	return IsAworked;
 }
+
+void testIsA::fBenchmarkIsA(classObject& aClass, TObject* aObj) {
+	auto cls = aClass.fGetTClass();
+	auto iterations = fGetSettings().lIterations;
+
+	// Reference: TObject itself always has the cached ClassDef-IsA().
+	static Double_t referenceIsANs = -1;
+	if (referenceIsANs < 0) {
+		TObject refObj;
+		TObject* refPtr = &refObj;
+		TClass* volatile refSink = nullptr;
+		referenceIsANs = benchmarkUtils::nsPerCall(iterations, [&]() {
+			refSink = refPtr->IsA();
+		});
+	}
+
+	TClass* volatile clsSink = nullptr;
+	volatile Bool_t inheritsSink = kFALSE;
+	auto tobjectClass = TObject::Class();
+	auto isANs = benchmarkUtils::nsPerCall(iterations, [&]() {
+		clsSink = aObj->IsA();
+	});
+	auto inheritsClassNs = benchmarkUtils::nsPerCall(iterations, [&]() {
+		inheritsSink = aObj->InheritsFrom(tobjectClass);
+	});
+	auto inheritsNameNs = benchmarkUtils::nsPerCall(iterations, [&]() {
+		inheritsSink = aObj->InheritsFrom("TObject");
+	});
+
+	// If the class has no ClassDef of its own, IsA() is inherited and returns a base class.
+	auto isAClass = aObj->IsA();
+	bool fastPathActive = (isAClass == cls);
+
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+	                          TString::Format("IsA-benchmark of class '%s': IsA() %.1f ns, InheritsFrom(TClass*) %.1f ns, InheritsFrom(const char*) %.1f ns per call, ClassDef fast path %s.",
+	                                  cls->GetName(), isANs, inheritsClassNs, inheritsNameNs,
+	                                  fastPathActive ? "in effect" : "NOT in effect"));
+	if (!fastPathActive) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("IsA() of class '%s' returns '%s', the class seems to lack a ClassDef!",
+		                                  cls->GetName(), isAClass->GetName()));
+	}
+	if (isANs > kSlowFactor * referenceIsANs && isANs - referenceIsANs > kSlowMarginNs) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("IsA() of class '%s' takes %.1f ns per call, %.1f times slower than the ClassDef fast path (%.1f ns for TObject)!",
+		                                  cls->GetName(), isANs, isANs / referenceIsANs, referenceIsANs));
+	}
+}
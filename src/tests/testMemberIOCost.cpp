@@ -0,0 +1,219 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testMemberIOCost.h"
+
+#include "benchmarkUtils.h"
+#include "errorHandling.h"
+
+#include <TBufferFile.h>
+#include <TClass.h>
+#include <TClonesArray.h>
+#include <TObjArray.h>
+#include <TPRegexp.h>
+#include <TStreamerElement.h>
+#include <TVirtualCollectionProxy.h>
+#include <TVirtualStreamerInfo.h>
+
+#include <vector>
+
+static testMemberIOCost instance = testMemberIOCost();
+
+namespace {
+	// Values of ROOT::ESTLType (TClassEdit::ESTLType in ROOT 5), only those of node-based containers.
+	enum nodeBasedCollection {
+		kList               = 2,
+		kMap                = 4,
+		kMultiMap           = 5,
+		kSet                = 6,
+		kMultiSet           = 7,
+		kForwardList        = 9,
+		kUnorderedSet       = 10,
+		kUnorderedMultiSet  = 11,
+		kUnorderedMap       = 12,
+		kUnorderedMultiMap  = 13
+	};
+
+	const char* getNodeBasedCollectionName(Int_t aCollectionType) {
+		switch (aCollectionType) {
+			case kList:               return "std::list";
+			case kMap:                return "std::map";
+			case kMultiMap:           return "std::multimap";
+			case kSet:                return "std::set";
+			case kMultiSet:           return "std::multiset";
+			case kForwardList:        return "std::forward_list";
+			case kUnorderedSet:       return "std::unordered_set";
+			case kUnorderedMultiSet:  return "std::unordered_multiset";
+			case kUnorderedMap:       return "std::unordered_map";
+			case kUnorderedMultiMap:  return "std::unordered_multimap";
+			default:                  return nullptr;
+		}
+	}
+
+	std::string stripPointer(const std::string& aTypeName) {
+		auto end = aTypeName.find_last_not_of("* ");
+		return aTypeName.substr(0, (end == std::string::npos) ? 0 : end + 1);
+	}
+
+	bool holdsClonesArray(TClass* aClass) {
+		auto info = aClass->GetStreamerInfo();
+		auto elements = (info != nullptr) ? info->GetElements() : nullptr;
+		for (Int_t i = 0; elements != nullptr && i < elements->GetEntriesFast(); ++i) {
+			auto element = dynamic_cast<TStreamerElement*>(elements->UncheckedAt(i));
+			if (element != nullptr && stripPointer(element->GetTypeName()) == "TClonesArray") {
+				return true;
+			}
+		}
+		return false;
+	}
+}
+
+template <typename Writer>
+testMemberIOCost::streamingCost testMemberIOCost::fMeasureStreaming(Writer aWriter) {
+	static TBufferFile buf(TBuffer::kWrite, 10000);
+	auto writeOnce = [&]() {
+		buf.SetWriteMode();
+		buf.ResetMap();
+		buf.SetBufferOffset(0);
+		aWriter(buf);
+	};
+	writeOnce();
+	Int_t bytes = buf.Length();
+	auto ns = benchmarkUtils::nsPerCall(kTimingIterations, writeOnce, 3);
+	buf.SetBufferOffset(0);
+	return streamingCost{bytes, ns};
+}
+
+bool testMemberIOCost::fRunTest(classObject& aClass) {
+	auto cls = aClass.fGetTClass();
+	auto& snapshot = aClass.fGetSnapshot();
+
+	std::vector<UInt_t> storageArenaVector(snapshot.fGetArenaUInts());
+	void* objAddress = cls->New(storageArenaVector.data(), TClass::kRealNew);
+	TObject* obj = static_cast<TObject*>(objAddress);
+	auto memberAddress = [objAddress](Int_t aOffset) {
+		return static_cast<void*>(static_cast<char*>(objAddress) + aOffset);
+	};
+
+	std::vector<finding> findings;
+	for (auto& element : snapshot.fGetStreamerElements()) {
+		if (element.lIsBase) {
+			continue;
+		}
+		auto typeName = stripPointer(element.lTypeName);
+		bool isPointer = (element.lType == TVirtualStreamerInfo::kSTLp || element.lType == TVirtualStreamerInfo::kObjectP
+		                  || element.lType == TVirtualStreamerInfo::kObjectp || element.lType == TVirtualStreamerInfo::kAnyP
+		                  || element.lType == TVirtualStreamerInfo::kAnyp);
+		void* address = memberAddress(element.lOffset);
+		if (isPointer) {
+			address = *static_cast<void**>(address);
+		}
+		if (address == nullptr) {
+			// Nothing to measure, and '//->' would be wrong.
+			continue;
+		}
+
+		if (element.lType == TVirtualStreamerInfo::kSTL || element.lType == TVirtualStreamerInfo::kSTLp) {
+			auto collectionClass = TClass::GetClass(typeName.c_str());
+			auto proxy = (collectionClass != nullptr) ? collectionClass->GetCollectionProxy() : nullptr;
+			auto collectionName = (proxy != nullptr) ? getNodeBasedCollectionName(proxy->GetCollectionType()) : nullptr;
+			if (collectionName == nullptr) {
+				continue;
+			}
+			UInt_t size = 0;
+			{
+				TVirtualCollectionProxy::TPushPop helper(proxy, address);
+				size = proxy->Size();
+			}
+			auto cost = fMeasureStreaming([&](TBufferFile& aBuf) {
+				collectionClass->Streamer(address, aBuf);
+			});
+			findings.push_back(finding{element.lName,
+			                           TString::Format("is a node-based %s (%u elements in the default object), which is read back with one allocation "
+			                                   "and insert per element. A std::vector is much cheaper where lookup or ordering is not needed.",
+			                                   collectionName, size),
+			                           errorHandling::kWarning, true, cost});
+		} else if (typeName == "TClonesArray") {
+			auto clonesArray = static_cast<TClonesArray*>(address);
+			auto innerClass = clonesArray->GetClass();
+			if (innerClass == nullptr || !holdsClonesArray(innerClass)) {
+				continue;
+			}
+			auto cost = fMeasureStreaming([&](TBufferFile& aBuf) {
+				clonesArray->Streamer(aBuf);
+			});
+			findings.push_back(finding{element.lName,
+			                           TString::Format("is a TClonesArray of '%s', which holds TClonesArrays itself. Nested clones arrays "
+			                                   "can not be split and are streamed object-wise.", innerClass->GetName()),
+			                           errorHandling::kWarning, true, cost});
+		} else if (element.lType == TVirtualStreamerInfo::kObjectP || element.lType == TVirtualStreamerInfo::kAnyP) {
+			auto pointeeClass = TClass::GetClass(typeName.c_str());
+			if (pointeeClass == nullptr || pointeeClass->GetActualClass(address) != pointeeClass) {
+				// Polymorphic use needs the full pointer streaming.
+				continue;
+			}
+			auto pointerCost = fMeasureStreaming([&](TBufferFile& aBuf) {
+				aBuf.WriteObjectAny(address, pointeeClass);
+			});
+			auto directCost = fMeasureStreaming([&](TBufferFile& aBuf) {
+				pointeeClass->Streamer(address, aBuf);
+			});
+			findings.push_back(finding{element.lName,
+			                           TString::Format("is a pointer to '%s' which is set in the default object, but lacks '//->'. "
+			                                   "Each object pays for the null check, class tag and pointer map.", typeName.c_str()),
+			                           errorHandling::kWarning, true,
+			                           streamingCost{pointerCost.lBytes - directCost.lBytes, pointerCost.lNs - directCost.lNs}});
+		}
+	}
+
+	// Those never make it into the streamer info, so look at the reflection data.
+	for (auto& member : snapshot.fGetMembers()) {
+		if (member.lOwnerName != snapshot.fGetClassName() || member.lIsNested || !member.lIsPointer || !member.lIsBasic
+		        || member.lDataType == reflectionSnapshot::kNoDataType || !member.lArrayIndex.empty()
+		        || member.lTransient || !member.lIsPersistent
+		        || member.lTypeName == "char" || member.lTypeName == "Char_t") {
+			// C-strings are streamed without size annotation.
+			continue;
+		}
+		findings.push_back(finding{member.lMemberName,
+		                           TString::Format("is a pointer to '%s' without '//[n]' size annotation, so it is not streamed at all.",
+		                                   member.lTypeName.c_str()),
+		                           errorHandling::kError, false, streamingCost{0, 0.}});
+	}
+
+	if (!findings.empty()) {
+		auto objectCost = fMeasureStreaming([&](TBufferFile& aBuf) {
+			aBuf.MapObject(obj);
+			obj->Streamer(aBuf);
+		});
+		for (auto& issue : findings) {
+			TString cost;
+			if (issue.lMeasured) {
+				cost = TString::Format(" Estimated cost: %d of %d bytes, %.1f of %.1f ns per streamed object.",
+				                       issue.lCost.lBytes, objectCost.lBytes, issue.lCost.lNs, objectCost.lNs);
+			}
+			TPRegexp searchExpr(TString::Format(".*[^_a-zA-Z]%s[^_a-zA-Z0-9].*", issue.lMemberName.c_str()));
+			errorHandling::throwError(cls->GetDeclFileName(), searchExpr, issue.lType,
+			                          TString::Format("Member '%s' of dataobject '%s' %s%s",
+			                                  issue.lMemberName.c_str(), cls->GetName(), issue.lProblem.Data(), cost.Data()));
+		}
+	}
+
+	cls->Destructor(objAddress, kTRUE);
+	return findings.empty();
+}
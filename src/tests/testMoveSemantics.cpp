@@ -0,0 +1,242 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testMoveSemantics.h"
+#include "errorHandling.h"
+
+#include <TBaseClass.h>
+#include <TClass.h>
+#include <TDataMember.h>
+#include <TInterpreter.h>
+#include <TList.h>
+#include <TMethod.h>
+#include <TMethodArg.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+
+static testMoveSemantics instance = testMoveSemantics();
+
+namespace {
+	// User-declared special members, as listed in the dictionary; implicit ones are not in there.
+	struct declaredMembers {
+		bool lCopyConstructor = false;
+		bool lMoveConstructor = false;
+		bool lCopyAssignment  = false;
+		bool lMoveAssignment  = false;
+		bool lDestructor      = false;
+	};
+
+	declaredMembers getDeclaredMembers(TClass* aClass) {
+		declaredMembers declared;
+		std::string className(aClass->GetName());
+		// Copy operations may also take a non-const reference, copy assignment even a value.
+		std::string copyArg = "const " + className + "&";
+		std::string nonConstCopyArg = className + "&";
+		std::string moveArg = className + "&&";
+		auto methods = aClass->GetListOfMethods();
+		if (methods == nullptr) {
+			return declared;
+		}
+		TIter nextMethod(methods);
+		TMethod* method = nullptr;
+		while ((method = dynamic_cast<TMethod*>(nextMethod())) != nullptr) {
+			if (method->ExtraProperty() & kIsDestructor) {
+				declared.lDestructor = true;
+				continue;
+			}
+			if (method->GetNargs() != 1) {
+				continue;
+			}
+			auto arg = static_cast<TMethodArg*>(method->GetListOfMethodArgs()->First());
+			std::string argType(arg->GetTypeNormalizedName());
+			bool copyArgType = (argType == copyArg || argType == nonConstCopyArg);
+			if (method->ExtraProperty() & kIsConstructor) {
+				declared.lCopyConstructor |= copyArgType;
+				declared.lMoveConstructor |= argType == moveArg;
+			} else if (strcmp(method->GetName(), "operator=") == 0) {
+				declared.lCopyAssignment |= copyArgType || argType == className;
+				declared.lMoveAssignment |= argType == moveArg;
+			}
+		}
+		return declared;
+	}
+
+	// User-declared members suppressing an implicit move operation ([class.copy]), empty if there are none.
+	TString getSuppressors(const declaredMembers& aDeclared, bool aForMoveConstructor) {
+		TString suppressors;
+		auto add = [&suppressors](bool aDeclaredMember, const char* aName) {
+			if (aDeclaredMember) {
+				suppressors += TString::Format("%s%s", suppressors.Length() > 0 ? ", " : "", aName);
+			}
+		};
+		add(aDeclared.lCopyConstructor, "copy constructor");
+		add(aDeclared.lCopyAssignment, "copy assignment");
+		// Each explicit move operation suppresses the other implicit one.
+		add(aForMoveConstructor ? aDeclared.lMoveAssignment : aDeclared.lMoveConstructor,
+		    aForMoveConstructor ? "move assignment" : "move constructor");
+		add(aDeclared.lDestructor, "destructor");
+		return suppressors;
+	}
+
+	const char* describe(bool aExists, bool aNoexcept) {
+		return aExists ? (aNoexcept ? "noexcept" : "may throw") : "none";
+	}
+
+	// Evaluates a (cached) type trait like "std::is_nothrow_move_constructible" for a type, true if unknown.
+	bool hasTrait(const char* aTrait, const std::string& aType) {
+		static std::map<std::pair<std::string, std::string>, bool> cache;
+		auto key = std::make_pair(std::string(aTrait), aType);
+		auto known = cache.find(key);
+		if (known != cache.end()) {
+			return known->second;
+		}
+		int interpreterError = 0;
+		Long_t value = gInterpreter->Calc(TString::Format("%s<%s>::value ? 1 : 0", aTrait, aType.c_str()).Data(), &interpreterError);
+		bool result = (interpreterError != 0) || value != 0;
+		cache[key] = result;
+		return result;
+	}
+
+	// Bases and data members whose move operation (via aTrait) may throw: an implicit move of aClass calls it.
+	TString getInheritedCauses(TClass* aClass, const char* aTrait) {
+		TString causes;
+		auto add = [&causes](const TString& aCause) {
+			causes += TString::Format("%s%s", causes.Length() > 0 ? ", " : "", aCause.Data());
+		};
+		auto bases = aClass->GetListOfBases();
+		if (bases != nullptr) {
+			TIter nextBase(bases);
+			TBaseClass* base = nullptr;
+			while ((base = dynamic_cast<TBaseClass*>(nextBase())) != nullptr) {
+				if (!hasTrait(aTrait, base->GetName())) {
+					add(TString::Format("base '%s'", base->GetName()));
+				}
+			}
+		}
+		auto members = aClass->GetListOfDataMembers();
+		if (members != nullptr) {
+			TIter nextMember(members);
+			TDataMember* member = nullptr;
+			while ((member = dynamic_cast<TDataMember*>(nextMember())) != nullptr) {
+				// Basic types, enums and pointers always move without throwing.
+				if ((member->Property() & kIsStatic) || member->IsBasic() || member->IsEnum() || member->IsaPointer()) {
+					continue;
+				}
+				if (!hasTrait(aTrait, member->GetTrueTypeName())) {
+					add(TString::Format("member '%s' (%s)", member->GetName(), member->GetTrueTypeName()));
+				}
+			}
+		}
+		return causes;
+	}
+}
+
+bool testMoveSemantics::fRunTest(classObject& aClass) {
+	auto cls = aClass.fGetTClass();
+
+	static bool traitsDeclared = gInterpreter->Declare("#include <type_traits>");
+	if (!traitsDeclared) {
+		return true;
+	}
+
+	// One expression per class, every Calc() is a separate compilation in cling.
+	TString type(cls->GetName());
+	TString expression = TString::Format("(std::is_copy_constructible<%s>::value ? %ld : 0)"
+	                                     " | (std::is_move_constructible<%s>::value ? %ld : 0)"
+	                                     " | (std::is_nothrow_move_constructible<%s>::value ? %ld : 0)"
+	                                     " | (std::is_move_assignable<%s>::value ? %ld : 0)"
+	                                     " | (std::is_nothrow_move_assignable<%s>::value ? %ld : 0)"
+	                                     " | (std::is_nothrow_copy_constructible<%s>::value ? %ld : 0)",
+	                                     type.Data(), static_cast<Long_t>(kCopyConstructible),
+	                                     type.Data(), static_cast<Long_t>(kMoveConstructible),
+	                                     type.Data(), static_cast<Long_t>(kNothrowMoveConstructible),
+	                                     type.Data(), static_cast<Long_t>(kMoveAssignable),
+	                                     type.Data(), static_cast<Long_t>(kNothrowMoveAssignable),
+	                                     type.Data(), static_cast<Long_t>(kNothrowCopyConstructible));
+	int interpreterError = 0;
+	Long_t traits = gInterpreter->Calc(expression.Data(), &interpreterError);
+	if (interpreterError != 0) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("Could not evaluate type traits of class '%s' in the interpreter.", cls->GetName()));
+		return true;
+	}
+
+	bool copyable = traits & kCopyConstructible;
+	if (!copyable) {
+		return true;
+	}
+	auto declared = getDeclaredMembers(cls);
+
+	// A class without any move constructor is still "move constructible" via the copy constructor,
+	// the dictionary tells whether a move constructor is actually declared.
+	auto moveConstructorSuppressors = getSuppressors(declared, true);
+	auto moveAssignmentSuppressors  = getSuppressors(declared, false);
+	bool moveConstructor = declared.lMoveConstructor || moveConstructorSuppressors.Length() == 0;
+	bool moveAssignment  = declared.lMoveAssignment  || moveAssignmentSuppressors.Length() == 0;
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+	                          TString::Format("Special members of class '%s': copy constructor: %s (%s), copy assignment: %s, move constructor: %s, move assignment: %s.",
+	                                  cls->GetName(),
+	                                  declared.lCopyConstructor ? "user-declared" : "implicit",
+	                                  (traits & kNothrowCopyConstructible) ? "noexcept" : "may throw",
+	                                  declared.lCopyAssignment ? "user-declared" : "implicit",
+	                                  describe(moveConstructor, traits & kNothrowMoveConstructible),
+	                                  describe(moveAssignment, traits & kNothrowMoveAssignable)));
+
+	if (!(traits & kNothrowMoveConstructible)) {
+		// An implicit move constructor (also a defaulted one) moves bases and members, those may be the cause.
+		auto inheritedCauses = getInheritedCauses(cls, "std::is_nothrow_move_constructible");
+		TString reason;
+		if (declared.lMoveConstructor) {
+			reason = " (the user-declared one is not noexcept)";
+		} else if (!moveConstructor) {
+			reason = TString::Format(" (implicit move suppressed by user-declared %s)", moveConstructorSuppressors.Data());
+		} else if (inheritedCauses.Length() > 0) {
+			// Nothing to fix in this class, the bases / members get flagged themselves.
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+			                          TString::Format("Copyable class '%s' has no noexcept move constructor, caused by %s.",
+			                                  cls->GetName(), inheritedCauses.Data()));
+			return true;
+		}
+		if (inheritedCauses.Length() > 0) {
+			reason += TString::Format(" (moving also throws for %s)", inheritedCauses.Data());
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("Copyable class '%s' has no noexcept move constructor%s, std::vector reallocation will copy it!",
+		                                  cls->GetName(), reason.Data()));
+		return false;
+	}
+	if (!(traits & kNothrowMoveAssignable)) {
+		TString reason;
+		if (declared.lMoveAssignment) {
+			reason = " (the user-declared one is not noexcept)";
+		} else if (!moveAssignment) {
+			reason = TString::Format(" (implicit move suppressed by user-declared %s)", moveAssignmentSuppressors.Data());
+		} else {
+			auto inheritedCauses = getInheritedCauses(cls, "std::is_nothrow_move_assignable");
+			if (inheritedCauses.Length() > 0) {
+				reason = TString::Format(", caused by %s", inheritedCauses.Data());
+			}
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("Copyable class '%s' has no noexcept move assignment%s!",
+		                                  cls->GetName(), reason.Data()));
+	}
+	return true;
+}
@@ -0,0 +1,179 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testSchemaEvolution.h"
+#include "errorHandling.h"
+#include "benchmarkUtils.h"
+
+#include <TClass.h>
+#include <TFile.h>
+#include <TKey.h>
+#include <TList.h>
+#include <TMemFile.h>
+#include <TObjArray.h>
+#include <TStreamerElement.h>
+#include <TStreamerInfo.h>
+
+#include <iostream>
+#include <memory>
+#include <set>
+
+static testSchemaEvolution instance = testSchemaEvolution();
+
+const std::map<std::string, std::vector<testSchemaEvolution::storedInfo>>& testSchemaEvolution::fGetReferenceInfos() {
+	static std::map<std::string, std::vector<storedInfo>> referenceInfos;
+	static bool loaded = false;
+	if (loaded) {
+		return referenceInfos;
+	}
+	loaded = true;
+	TDirectory::TContext directoryContext;
+	for (auto& fileName : fGetSettings().lReferenceFiles) {
+		std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+		if (!file || file->IsZombie()) {
+			std::cerr << "Reference file '" << fileName << "' could not be opened!" << std::endl;
+			continue;
+		}
+		// The list and its infos are ours, the file already registered its own copies with the classes.
+		std::unique_ptr<TList> infos(file->GetStreamerInfoList());
+		if (!infos) {
+			continue;
+		}
+		TIter nextInfo(infos.get());
+		TObject* infoObj = nullptr;
+		while ((infoObj = nextInfo()) != nullptr) {
+			auto info = dynamic_cast<TStreamerInfo*>(infoObj);
+			if (info == nullptr) {
+				// E.g. the list of schema rules.
+				continue;
+			}
+			storedInfo stored{fileName, info->GetClassVersion(), info->GetCheckSum(), {}};
+			auto elements = info->GetElements();
+			for (Int_t i = 0; elements != nullptr && i < elements->GetEntriesFast(); ++i) {
+				auto element = dynamic_cast<TStreamerElement*>(elements->UncheckedAt(i));
+				if (element != nullptr) {
+					stored.lElements.emplace_back(element->GetName(), element->GetTypeName());
+				}
+			}
+			referenceInfos[info->GetName()].push_back(std::move(stored));
+		}
+		infos->Delete();
+		file->Close();
+	}
+	return referenceInfos;
+}
+
+bool testSchemaEvolution::fRunTest(classObject& aClass) {
+	static const auto streamingId = fGetTestId("Streaming");
+	auto cls = aClass.fGetTClass();
+	auto& snapshot = aClass.fGetSnapshot();
+
+	std::map<std::string, std::string> liveElements;
+	for (auto& element : snapshot.fGetStreamerElements()) {
+		liveElements[element.lName] = element.lTypeName;
+	}
+
+	bool needsConversion = false;
+	for (auto& stored : fGetReferenceInfos().at(aClass.fGetClassName())) {
+		if (stored.lVersion == snapshot.fGetClassVersion() && stored.lCheckSum == snapshot.fGetCheckSum()) {
+			continue;
+		}
+		needsConversion = true;
+
+		TString changes;
+		std::set<std::string> storedNames;
+		for (auto& element : stored.lElements) {
+			storedNames.insert(element.first);
+			auto live = liveElements.find(element.first);
+			if (live == liveElements.end()) {
+				changes += TString::Format(" removed '%s %s';", element.second.c_str(), element.first.c_str());
+			} else if (live->second != element.second) {
+				changes += TString::Format(" changed '%s' from '%s' to '%s';", element.first.c_str(), element.second.c_str(), live->second.c_str());
+			}
+		}
+		for (auto& element : liveElements) {
+			if (storedNames.find(element.first) == storedNames.end()) {
+				changes += TString::Format(" added '%s %s';", element.second.c_str(), element.first.c_str());
+			}
+		}
+		if (changes.Length() == 0) {
+			changes = " no member changes visible (order or checksum-relevant details differ);";
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("Reading class '%s' from '%s' (version %d, checksum 0x%x) needs schema evolution to version %d (checksum 0x%x):%s",
+		                                  cls->GetName(), stored.lFile.c_str(), stored.lVersion, stored.lCheckSum,
+		                                  snapshot.fGetClassVersion(), snapshot.fGetCheckSum(), changes.Data()));
+		if (fGetSettings().lBenchmark && aClass.fWasTestedSuccessfully(streamingId)) {
+			fBenchmarkConversion(aClass, stored);
+		}
+	}
+	return !needsConversion;
+}
+
+void testSchemaEvolution::fBenchmarkConversion(classObject& aClass, const storedInfo& aInfo) {
+	auto cls = aClass.fGetTClass();
+	TDirectory::TContext directoryContext;
+
+	std::unique_ptr<TFile> file(TFile::Open(aInfo.lFile.c_str()));
+	if (!file || file->IsZombie()) {
+		return;
+	}
+	// Samples are only looked for at the top level of the file.
+	TKey* sampleKey = nullptr;
+	TIter nextKey(file->GetListOfKeys());
+	TKey* key = nullptr;
+	while ((key = dynamic_cast<TKey*>(nextKey())) != nullptr) {
+		if (aClass.fGetClassName() == key->GetClassName()) {
+			sampleKey = key;
+			break;
+		}
+	}
+	if (sampleKey == nullptr) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("No sample of class '%s' at the top level of '%s', can not benchmark its conversion.",
+		                                  cls->GetName(), aInfo.lFile.c_str()));
+		return;
+	}
+
+	std::unique_ptr<TObject> sample(sampleKey->ReadObj());
+	if (!sample) {
+		return;
+	}
+	// Same object, same compression, current class version.
+	TMemFile currentFile("schemaEvolutionSample.root", "RECREATE");
+	currentFile.WriteTObject(sample.get(), "sample");
+	auto currentKey = currentFile.GetKey("sample");
+	if (currentKey == nullptr) {
+		return;
+	}
+
+	auto readKey = [](TKey * aKey) {
+		std::unique_ptr<TObject> obj(aKey->ReadObj());
+	};
+	Double_t convertingNs = benchmarkUtils::nsPerCall(kBenchmarkReads, [&]() {
+		readKey(sampleKey);
+	});
+	Double_t currentNs = benchmarkUtils::nsPerCall(kBenchmarkReads, [&]() {
+		readKey(currentKey);
+	});
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+	                          TString::Format("Reading a sample of class '%s' from '%s' takes %.0f ns with schema evolution, %.0f ns without (%.1fx).",
+	                                  cls->GetName(), aInfo.lFile.c_str(), convertingNs, currentNs,
+	                                  (currentNs > 0) ? convertingNs / currentNs : 0.));
+	currentFile.Close();
+}
@@ -29,8 +29,7 @@ static testStreaming instance = testStreaming();
 bool testStreaming::fRunTest(classObject& aClass) {
 	auto cls = aClass.fGetTClass();
 
-	UInt_t classSize = cls->Size();
-	UInt_t uintCount = classSize / sizeof(UInt_t) + 1;
+	auto uintCount = aClass.fGetSnapshot().fGetArenaUInts();
 	std::vector<UInt_t> storageArenaVector(uintCount);
 	auto storageArena = storageArenaVector.data();
 
@@ -41,7 +40,7 @@ bool testStreaming::fRunTest(classObject& aClass) {
 		streamingUtils::streamObjectToBufferAndChecksum(obj);
 	} CATCH ( excode ) {
 		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
-		                          TString::Format("Streaming of class '%s' failed fatally, needs manual investigation! Check the stacktrace!",
+		                          TString::Format("Streaming of class '%s' failed fatally, needs manual investigation! Check the backtrace reported for it!",
 		                                  cls->GetName()));
 		streamingWorked = false;
 		Throw( excode );
@@ -0,0 +1,124 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testStreamingFuzz.h"
+
+#include "errorHandling.h"
+#include "streamingUtils.h"
+
+#include <TBufferFile.h>
+#include <TClass.h>
+#include <TDataMember.h>
+#include <TPRegexp.h>
+#include <TRealData.h>
+
+#include <chrono>
+#include <functional>
+#include <set>
+#include <string.h>
+
+static testStreamingFuzz instance = testStreamingFuzz();
+
+bool testStreamingFuzz::fRunTest(classObject& aClass) {
+	auto cls = aClass.fGetTClass();
+
+	auto members = streamingUtils::getFuzzableMembers(aClass.fGetSnapshot());
+	if (members.empty()) {
+		// Nothing we could randomize.
+		return true;
+	}
+
+	static TBufferFile buf(TBuffer::kWrite, 64 * 1024);
+
+	// The written object is re-randomized from its seed to compare with what was read back,
+	// so a batch only costs the buffer and two objects.
+	TObject* obj     = static_cast<TObject*>(cls->New(TClass::kRealNew));
+	TObject* readObj = static_cast<TObject*>(cls->New(TClass::kRealNew));
+
+	auto roundTrips = fGetSettings().lFuzzRoundTrips;
+	auto seedBase = std::hash<std::string>()(aClass.fGetClassName());
+	std::vector<Int_t> objectOffsets(kBatchSize + 1);
+	std::set<TRealData*> brokenMembers;
+	bool lengthMismatch = false;
+
+	auto start = std::chrono::steady_clock::now();
+	for (std::size_t batchStart = 0; batchStart < roundTrips && !lengthMismatch; batchStart += kBatchSize) {
+		std::size_t batchSize = roundTrips - batchStart;
+		if (batchSize > kBatchSize) {
+			batchSize = kBatchSize;
+		}
+
+		buf.SetWriteMode();
+		buf.SetBufferOffset(0);
+		for (std::size_t i = 0; i < batchSize; ++i) {
+			std::mt19937_64 rng(seedBase + batchStart + i);
+			streamingUtils::randomizeMembers(obj, members, rng);
+			objectOffsets[i] = buf.Length();
+			buf.ResetMap();
+			buf.MapObject(obj);
+			obj->Streamer(buf);
+		}
+		objectOffsets[batchSize] = buf.Length();
+
+		buf.SetReadMode();
+		for (std::size_t i = 0; i < batchSize; ++i) {
+			buf.SetBufferOffset(objectOffsets[i]);
+			// Same mapping as on writing, so self-references resolve.
+			buf.ResetMap();
+			buf.MapObject(readObj);
+			readObj->Streamer(buf);
+			if (buf.Length() != objectOffsets[i + 1]) {
+				errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+				                          TString::Format("Dataobject '%s' with random member values reads %d bytes, but wrote %d bytes!",
+				                                  cls->GetName(), buf.Length() - objectOffsets[i], objectOffsets[i + 1] - objectOffsets[i]));
+				lengthMismatch = true;
+				break;
+			}
+			std::mt19937_64 rng(seedBase + batchStart + i);
+			streamingUtils::randomizeMembers(obj, members, rng);
+			for (auto& member : members) {
+				auto offset = member.lOffset;
+				if (memcmp(reinterpret_cast<UChar_t*>(obj) + offset, reinterpret_cast<UChar_t*>(readObj) + offset,
+				           member.lUnitSize * member.lElements) != 0) {
+					brokenMembers.insert(member.lRealData);
+				}
+			}
+		}
+	}
+	auto stop = std::chrono::steady_clock::now();
+	buf.SetWriteMode();
+	buf.SetBufferOffset(0);
+
+	for (auto rd : brokenMembers) {
+		TPRegexp searchExpr(TString::Format(".*[^_a-zA-Z]%s[^_a-zA-Z0-9].*", rd->GetDataMember()->GetName()));
+		errorHandling::throwError(cls->GetDeclFileName(), searchExpr, errorHandling::kError,
+		                          TString::Format("Member '%s' of dataobject '%s' does not survive a streaming round-trip with random values!",
+		                                  rd->GetName(), cls->GetName()));
+	}
+
+	if (fGetSettings().lBenchmark && roundTrips > 0) {
+		Double_t ns = std::chrono::duration<Double_t, std::nano>(stop - start).count();
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("StreamingFuzz of class '%s': %zu round-trips with %zu random members, %.1f ns per round-trip.",
+		                                  cls->GetName(), roundTrips, members.size(), ns / roundTrips));
+	}
+
+	cls->Destructor(readObj);
+	cls->Destructor(obj);
+	return brokenMembers.empty() && !lengthMismatch;
+}
@@ -0,0 +1,113 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testStreamingReadBack.h"
+
+#include "errorHandling.h"
+#include "streamingUtils.h"
+#include "memoryUtils.h"
+#include "benchmarkUtils.h"
+
+#include <TBufferFile.h>
+#include <TClass.h>
+
+static testStreamingReadBack instance = testStreamingReadBack();
+
+bool testStreamingReadBack::fRunTest(classObject& aClass) {
+	auto cls = aClass.fGetTClass();
+
+	auto uintCount = aClass.fGetSnapshot().fGetArenaUInts();
+	std::vector<UInt_t> storageArenaVector(uintCount);
+	std::vector<UInt_t> readArenaVector(uintCount);
+
+	TObject* obj     = static_cast<TObject*>(cls->New(storageArenaVector.data(), TClass::kRealNew));
+	TObject* readObj = static_cast<TObject*>(cls->New(readArenaVector.data(), TClass::kRealNew));
+
+	static TBufferFile buf(TBuffer::kWrite, 10000);
+	auto writeOnce = [&]() {
+		buf.SetWriteMode();
+		streamingUtils::streamObjectToBuffer(buf, obj);
+	};
+	auto readOnce = [&]() {
+		buf.SetReadMode();
+		buf.SetBufferOffset(0);
+		buf.ResetMap();
+		buf.MapObject(readObj);
+		readObj->Streamer(buf);
+	};
+
+	bool readBackWorked = true;
+
+	writeOnce();
+	Int_t writtenLength = buf.Length();
+	auto writtenChecksum = streamingUtils::checksumBuffer(buf);
+
+	readOnce();
+	if (buf.Length() != writtenLength) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+		                          TString::Format("Dataobject '%s' reads %d bytes, but wrote %d bytes!",
+		                                  cls->GetName(), buf.Length(), writtenLength));
+		readBackWorked = false;
+	} else {
+		auto reStreamedChecksum = streamingUtils::streamObjectToBufferAndChecksum(readObj);
+		if (reStreamedChecksum != writtenChecksum) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+			                          TString::Format("Dataobject '%s' streams different bytes after being read back!",
+			                                  cls->GetName()));
+			readBackWorked = false;
+		}
+	}
+
+	if (readBackWorked) {
+		// The read path may allocate once (e.g. StreamerInfo-caches), but it must not keep on doing so.
+		for (std::size_t i = 0; i < kLeakWarmupReads; ++i) {
+			readOnce();
+		}
+		auto heapBefore = memoryUtils::getHeapInUse();
+		for (std::size_t i = 0; i < kLeakCheckReads; ++i) {
+			readOnce();
+		}
+		auto heapAfter = memoryUtils::getHeapInUse();
+		if (heapAfter > heapBefore + kLeakToleranceBytes) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kError,
+			                          TString::Format("Reading dataobject '%s' leaks about %.1f bytes per read!",
+			                                  cls->GetName(), static_cast<Double_t>(heapAfter - heapBefore) / kLeakCheckReads));
+			readBackWorked = false;
+		}
+	}
+
+	if (readBackWorked && fGetSettings().lBenchmark) {
+		auto iterations = fGetSettings().lIterations;
+		auto writeNs = benchmarkUtils::nsPerCall(iterations, writeOnce);
+		auto readNs  = benchmarkUtils::nsPerCall(iterations, readOnce);
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+		                          TString::Format("StreamingReadBack of class '%s': %d bytes, write %.1f ns, read %.1f ns per object.",
+		                                  cls->GetName(), writtenLength, writeNs, readNs));
+		if (readNs > kSlowFactor * writeNs) {
+			errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+			                          TString::Format("Reading dataobject '%s' is %.1f times slower than writing it!",
+			                                  cls->GetName(), readNs / writeNs));
+		}
+	}
+
+	buf.SetWriteMode();
+	buf.SetBufferOffset(0);
+	cls->Destructor(readObj, kTRUE);
+	cls->Destructor(obj, kTRUE);
+	return readBackWorked;
+}
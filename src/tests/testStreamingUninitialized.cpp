@@ -32,9 +32,9 @@ bool testStreamingUninitialized::fRunTest(classObject& aClass) {
 	bool streamsUninitializedContent = false;
 	
 	auto cls = aClass.fGetTClass();
+	auto& snapshot = aClass.fGetSnapshot();
 
-	UInt_t classSize = cls->Size();
-	UInt_t uintCount = classSize / sizeof(UInt_t) + 1;
+	auto uintCount = snapshot.fGetArenaUInts();
 	std::vector<UInt_t> storageArenaVector(uintCount);
 	auto storageArena = storageArenaVector.data();
 
@@ -46,19 +46,19 @@ bool testStreamingUninitialized::fRunTest(classObject& aClass) {
 	std::fill(&storageArena[0], &storageArena[uintCount], uninitializedUint_1);
 	obj = static_cast<TObject*>(cls->New(storageArena, TClass::kRealNew));
 	auto digest_1a  = streamingUtils::streamObjectToBufferAndChecksum(obj);
-	auto digests_1a = streamingUtils::getRealDataDigests(obj);
+	auto digests_1a = streamingUtils::getRealDataDigests(obj, snapshot);
 	cls->Destructor(obj, kTRUE);
 
 	std::fill(&storageArena[0], &storageArena[uintCount], uninitializedUint_1);
 	obj = static_cast<TObject*>(cls->New(storageArena, TClass::kRealNew));
 	auto digest_1b  = streamingUtils::streamObjectToBufferAndChecksum(obj);
-	auto digests_1b = streamingUtils::getRealDataDigests(obj);
+	auto digests_1b = streamingUtils::getRealDataDigests(obj, snapshot);
 	cls->Destructor(obj, kTRUE);
 
 	std::fill(&storageArena[0], &storageArena[uintCount], uninitializedUint_2);
 	obj = static_cast<TObject*>(cls->New(storageArena, TClass::kRealNew));
 	auto digest_2  = streamingUtils::streamObjectToBufferAndChecksum(obj);
-	auto digests_2 = streamingUtils::getRealDataDigests(obj);
+	auto digests_2 = streamingUtils::getRealDataDigests(obj, snapshot);
 	cls->Destructor(obj, kTRUE);
 
 
@@ -0,0 +1,145 @@
+/*
+  rootStaticAnalyzer - A simple post-compile-time analyzer for ROOT and ROOT-based projects.
+  Copyright (C) 2016  Oliver Freyermuth
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "testTreeSplitting.h"
+
+#include "errorHandling.h"
+#include "streamingUtils.h"
+
+#include <TBranch.h>
+#include <TClass.h>
+#include <TMemFile.h>
+#include <TObjArray.h>
+#include <TTree.h>
+
+#include <chrono>
+#include <functional>
+#include <random>
+
+static testTreeSplitting instance = testTreeSplitting();
+
+namespace {
+	Int_t countBranches(TObjArray* aBranches) {
+		Int_t count = 0;
+		for (Int_t i = 0; aBranches != nullptr && i < aBranches->GetEntriesFast(); ++i) {
+			auto branch = static_cast<TBranch*>(aBranches->UncheckedAt(i));
+			count += 1 + countBranches(branch->GetListOfBranches());
+		}
+		return count;
+	}
+}
+
+testTreeSplitting::layoutResult testTreeSplitting::fMeasureLayout(classObject& aClass, Int_t aSplitLevel, bool aRandomize) {
+	auto cls = aClass.fGetTClass();
+	layoutResult result{0, 0, 0, 0, 0., 0.};
+
+	std::vector<streamingUtils::fuzzableMember> members;
+	if (aRandomize) {
+		members = streamingUtils::getFuzzableMembers(aClass.fGetSnapshot());
+	}
+	// Same seed for both layouts, so both store the same content.
+	std::mt19937_64 rng(std::hash<std::string>()(aClass.fGetClassName()));
+
+	TDirectory::TContext directoryContext;
+	TMemFile file("treeSplitting.root", "RECREATE");
+	file.cd();
+	// Owned by the file.
+	auto tree = new TTree("splitting", "splitting");
+
+	void* obj = cls->New(TClass::kRealNew);
+	auto branch = tree->Branch("obj", cls->GetName(), &obj, 32000, aSplitLevel);
+	if (branch == nullptr) {
+		cls->Destructor(obj);
+		return result;
+	}
+	result.lTopSplitLevel = (branch->GetListOfBranches() != nullptr && branch->GetListOfBranches()->GetEntriesFast() > 0) ? branch->GetSplitLevel() : 0;
+	result.lBranches = countBranches(tree->GetListOfBranches());
+
+	auto writeStart = std::chrono::steady_clock::now();
+	for (Long64_t entry = 0; entry < kEntries; ++entry) {
+		if (!members.empty()) {
+			streamingUtils::randomizeMembers(obj, members, rng);
+		}
+		tree->Fill();
+	}
+	tree->FlushBaskets();
+	auto writeStop = std::chrono::steady_clock::now();
+	result.lWriteNs = std::chrono::duration<Double_t, std::nano>(writeStop - writeStart).count() / kEntries;
+	result.lTotBytes = tree->GetTotBytes();
+	result.lZipBytes = tree->GetZipBytes();
+	tree->ResetBranchAddresses();
+	cls->Destructor(obj);
+
+	void* readObj = nullptr;
+	tree->SetBranchAddress("obj", &readObj);
+	auto readStart = std::chrono::steady_clock::now();
+	for (Long64_t entry = 0; entry < kEntries; ++entry) {
+		tree->GetEntry(entry);
+	}
+	auto readStop = std::chrono::steady_clock::now();
+	result.lReadNs = std::chrono::duration<Double_t, std::nano>(readStop - readStart).count() / kEntries;
+	tree->ResetBranchAddresses();
+	if (readObj != nullptr) {
+		cls->Destructor(readObj);
+	}
+
+	file.Close();
+	return result;
+}
+
+bool testTreeSplitting::fRunTest(classObject& aClass) {
+	static const auto streamingFuzzId = fGetTestId("StreamingFuzz");
+	auto cls = aClass.fGetTClass();
+	auto& snapshot = aClass.fGetSnapshot();
+	bool randomize = aClass.fWasTestedSuccessfully(streamingFuzzId);
+
+	auto unsplit = fMeasureLayout(aClass, 0, randomize);
+	auto split   = fMeasureLayout(aClass, 99, randomize);
+
+	errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kNotice,
+	                          TString::Format("TreeSplitting of class '%s' (%lld %s entries): unsplit %d branch(es), %lld / %lld bytes (zipped / total), write %.0f ns, read %.0f ns; "
+	                                  "split %d branches, %lld / %lld bytes, write %.0f ns, read %.0f ns.",
+	                                  cls->GetName(), static_cast<long long>(kEntries), randomize ? "randomized" : "default-constructed",
+	                                  unsplit.lBranches, static_cast<long long>(unsplit.lZipBytes), static_cast<long long>(unsplit.lTotBytes), unsplit.lWriteNs, unsplit.lReadNs,
+	                                  split.lBranches, static_cast<long long>(split.lZipBytes), static_cast<long long>(split.lTotBytes), split.lWriteNs, split.lReadNs));
+
+	bool splitsWell = true;
+	if (split.lTopSplitLevel == 0) {
+		TString reasons;
+		if (snapshot.fHasCustomStreamerMember()) {
+			reasons += " custom streamer;";
+		}
+		for (auto& member : snapshot.fGetMembers()) {
+			if (!member.lIsNested && !member.lTransient && member.lIsPointer) {
+				reasons += TString::Format(" pointer member '%s';", member.lName.c_str());
+			}
+		}
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("Dataobject '%s' can not be split into a TTree, all members go into one slow branch!%s",
+		                                  cls->GetName(), reasons.Data()));
+		splitsWell = false;
+	} else if (unsplit.lReadNs > 0 && unsplit.lZipBytes > 0
+	           && (split.lReadNs > kSlowFactor * unsplit.lReadNs || split.lZipBytes > kLargerFactor * unsplit.lZipBytes)) {
+		errorHandling::throwError(cls->GetDeclFileName(), 0, errorHandling::kWarning,
+		                          TString::Format("Dataobject '%s' loses against its unsplit form: reading %.1f times slower, %.1f times the compressed size!",
+		                                  cls->GetName(), split.lReadNs / unsplit.lReadNs,
+		                                  static_cast<Double_t>(split.lZipBytes) / unsplit.lZipBytes));
+		splitsWell = false;
+	}
+	return splitsWell;
+}
@@ -17,6 +17,8 @@
 */
 
 #include "utilityFunctions.h"
+#include "testInterface.h"
+#include "errorHandling.h"
 
 #include <TSystem.h>
 #include <TROOT.h>
@@ -28,6 +30,7 @@
 
 #include <iostream>
 #include <algorithm>
+#include <sstream>
 
 // Inspired by TSystem::IsFileInIncludePath(), extended with possibility to strip ROOT_INCLUDE_PATH from lookup for special checks.
 TString utilityFunctions::searchInIncludePath(const char* aFileName, Bool_t aStripRootIncludePath) {
@@ -106,26 +109,52 @@ TString utilityFunctions::performPathLookup(const char* file, Bool_t aRemoveRoot
 	return fileName;
 }
 
-void utilityFunctions::parseRootmap(const char* aFilename, std::set<std::string>& classNames) {
+namespace {
+	std::vector<std::string> splitLibraries(const char* aLibraries) {
+		std::vector<std::string> libraries;
+		std::istringstream stream(aLibraries);
+		std::string library;
+		while (stream >> library) {
+			libraries.push_back(library);
+		}
+		return libraries;
+	}
+}
+
+void utilityFunctions::parseRootmap(const char* aFilename, rootmapRegistry& aRegistry) {
 	FILE *f = fopen(aFilename, "r");
+	if (f == nullptr) {
+		return;
+	}
 	char line[4096];
+	Int_t lineNo = 0;
+	// ROOT6-rootmaps name the libraries once per section, for all declarations following.
+	std::vector<std::string> sectionLibraries;
 	while (fgets(line, sizeof(line), f) != nullptr) {
+		lineNo++;
 		char className[1024];
 		int conversions = sscanf(line, "Library.%s:%*[^\n]", className);
 		//std::cout << conversions << std::endl;
 		if (conversions == 1) {
-			// ROOT5-rootmap format, all fine.
+			// ROOT5-rootmap format, all fine. The libraries follow the colon.
 			char *lastColon = strrchr(className, ':');
 			(*lastColon) = '\0';
 			std::replace(className, lastColon, '@', ':');
 			std::replace(className, lastColon, '-', ' ');
-			classNames.insert(className);
+			aRegistry.emplace(className, rootmapRegistration{aFilename, lineNo, splitLibraries(strchr(line, ':') + 1)});
+		} else if (line[0] == '[') {
+			// ROOT6-rootmap section: [ libFoo.so libDependency.so ]
+			auto sectionEnd = strchr(line, ']');
+			if (sectionEnd != nullptr) {
+				*sectionEnd = '\0';
+			}
+			sectionLibraries = splitLibraries(line + 1);
 		} else {
 			// New rootmap-format?
 			conversions = sscanf(line, "class %[^\n]", className);
 			if (conversions == 1) {
 				// ROOT6-rootmap format, all fine.
-				classNames.insert(className);
+				aRegistry.emplace(className, rootmapRegistration{aFilename, lineNo, sectionLibraries});
 			} else {
 				if (conversions == EOF) {
 					break;
@@ -161,7 +190,7 @@ TString utilityFunctions::getRootLibDir() {
 	return rootLibDir;
 }
 
-std::set<std::string> utilityFunctions::getRootmapsByRegexps(const std::vector<std::string>& rootMapPatterns, bool debug) {
+utilityFunctions::rootmapRegistry utilityFunctions::getRootmapsByRegexps(const std::vector<std::string>& rootMapPatterns, bool debug) {
 
 	std::vector<TPRegexp> rootMapRegexps;
 	for (auto& pattern : rootMapPatterns) {
@@ -169,7 +198,7 @@ std::set<std::string> utilityFunctions::getRootmapsByRegexps(const std::vector<s
 	}
 
 	// Construct list of all classes to test.
-	std::set<std::string> allClasses;
+	rootmapRegistry allClasses;
 	{
 		TObjArray* rootMaps = gInterpreter->GetRootMapFiles();
 		TIter next(rootMaps);
@@ -193,6 +222,79 @@ std::set<std::string> utilityFunctions::getRootmapsByRegexps(const std::vector<s
 	return allClasses;
 }
 
+std::set<std::string> utilityFunctions::getClassNames(const rootmapRegistry& aRegistry) {
+	std::set<std::string> classNames;
+	for (auto& registration : aRegistry) {
+		classNames.insert(classNames.end(), registration.first);
+	}
+	return classNames;
+}
+
+std::size_t utilityFunctions::checkRootmapRegistrations(const rootmapRegistry& aRegistry) {
+	std::size_t findings = 0;
+	// Library list => classes autoloading it, to report the cost of each list only once.
+	std::map<std::vector<std::string>, std::vector<std::string>> classesByLibraries;
+
+	for (auto registration = aRegistry.begin(); registration != aRegistry.end(); ) {
+		auto classRange = aRegistry.equal_range(registration->first);
+		registration = classRange.second;
+		auto& first = classRange.first->second;
+		classesByLibraries[first.lLibraries].push_back(classRange.first->first);
+
+		std::size_t count = std::distance(classRange.first, classRange.second);
+		if (count < 2) {
+			continue;
+		}
+		bool conflicting = false;
+		TString registrations;
+		for (auto other = classRange.first; other != classRange.second; ++other) {
+			auto& libraries = other->second.lLibraries;
+			registrations += TString::Format(" '%s' line %d (%s);", other->second.lRootmap.c_str(), other->second.lLine,
+			                                 libraries.empty() ? "no library" : libraries.front().c_str());
+			if (libraries.empty() != first.lLibraries.empty()
+			        || (!libraries.empty() && libraries.front() != first.lLibraries.front())) {
+				conflicting = true;
+			}
+		}
+		if (conflicting) {
+			errorHandling::throwError(first.lRootmap.c_str(), first.lLine, errorHandling::kError,
+			                          TString::Format("Class '%s' is registered for different libraries in %zu places, "
+			                                  "which one gets autoloaded depends on the order of the rootmaps:%s",
+			                                  classRange.first->first.c_str(), count, registrations.Data()));
+		} else {
+			errorHandling::throwError(first.lRootmap.c_str(), first.lLine, errorHandling::kWarning,
+			                          TString::Format("Class '%s' is registered %zu times for the same library:%s",
+			                                  classRange.first->first.c_str(), count, registrations.Data()));
+		}
+		++findings;
+	}
+
+	// Most extra libraries first.
+	typedef decltype(classesByLibraries)::const_iterator libraryList;
+	std::vector<libraryList> libraryLists;
+	for (auto list = classesByLibraries.cbegin(); list != classesByLibraries.cend(); ++list) {
+		if (list->first.size() > 1) {
+			libraryLists.push_back(list);
+		}
+	}
+	std::stable_sort(libraryLists.begin(), libraryLists.end(), [](const libraryList& aLhs, const libraryList& aRhs) {
+		return aLhs->first.size() > aRhs->first.size();
+	});
+	for (auto& list : libraryLists) {
+		TString extraLibraries;
+		for (std::size_t i = 1; i < list->first.size(); ++i) {
+			extraLibraries += " " + TString(list->first[i]);
+		}
+		auto& someClass = list->second.front();
+		auto& someRegistration = aRegistry.find(someClass)->second;
+		errorHandling::throwError(someRegistration.lRootmap.c_str(), someRegistration.lLine, errorHandling::kNotice,
+		                          TString::Format("Autoloading any of %zu classes (e.g. '%s') from '%s' loads %zu extra libraries:%s",
+		                                  list->second.size(), someClass.c_str(), list->first.front().c_str(),
+		                                  list->first.size() - 1, extraLibraries.Data()));
+	}
+	return findings;
+}
+
 void utilityFunctions::filterSetByPatterns(std::set<std::string>& allNames,
         const std::vector<std::string>& namePatterns,
         const std::vector<std::string>& nameAntiPatterns,
@@ -243,3 +345,38 @@ void utilityFunctions::filterSetByPatterns(std::set<std::string>& allNames,
 		}
 	}
 }
+
+std::vector<testInterface*> utilityFunctions::selectTestsByPatterns(const std::vector<std::string>& testNamePatterns,
+        const std::vector<std::string>& testNameAntiPatterns,
+        bool debug) {
+	auto& allTests = testInterface::fGetAllTests();
+	std::set<std::string> testNames;
+	for (auto& test : allTests) {
+		testNames.insert(test.first);
+	}
+	filterSetByPatterns(testNames, testNamePatterns, testNameAntiPatterns, debug);
+	std::vector<testInterface*> tests;
+	for (auto& testName : testNames) {
+		tests.push_back(allTests.at(testName));
+	}
+	return tests;
+}
+
+std::string utilityFunctions::getProvidingLibraryPath(TClass* aClass) {
+	std::string libraryPath;
+	auto sharedLibs = aClass->GetSharedLibs();
+	if (sharedLibs == nullptr) {
+		return libraryPath;
+	}
+	// The first library is the one providing the class, the others are its dependencies.
+	std::istringstream libStream(sharedLibs);
+	std::string library;
+	if (libStream >> library) {
+		auto libraryWithPath = gSystem->Which(gSystem->GetDynamicPath(), library.c_str());
+		if (libraryWithPath != nullptr) {
+			libraryPath = libraryWithPath;
+			delete [] libraryWithPath;
+		}
+	}
+	return libraryPath;
+}